@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <vga.h>
+#include <perf.h>
+#include <locks.h>
+#include <atomic.h>
+#include <barriers.h>
+#include <cpu2.h>
+#include <cpu3.h>
+
+#define NR_OF_INCREMENTS  10000   // increments performed by every CPU
+#define NR_OF_CPUS        3
+#define BENCH_LOCK_ID     0
+#define LOCKED_COUNTER    ATOMIC_WORD(0)  // plain word, only touched under BENCH_LOCK_ID
+#define ATOMIC_COUNTER    ATOMIC_WORD(1)  // only touched with atomic_fetch_add
+#define SELF_TEST_WORD    ATOMIC_WORD(2)  // scratch word of the l.cas self-test
+
+// Stack offsets of CPU2/CPU3 below the stack top of CPU1
+#define CPU2_STACK_OFFSET 0x4000
+#define CPU3_STACK_OFFSET 0x8000
+
+static void locked_increments() {
+  volatile uint32_t *counter = LOCKED_COUNTER;
+  for (int i = 0; i < NR_OF_INCREMENTS; i++) {
+    get_lock(BENCH_LOCK_ID);
+    *counter = *counter + 1;
+    release_lock(BENCH_LOCK_ID);
+  }
+}
+
+static void atomic_increments() {
+  for (int i = 0; i < NR_OF_INCREMENTS; i++) {
+    atomic_fetch_add(ATOMIC_COUNTER, 1);
+  }
+}
+
+//! Both contended phases, every CPU enters and leaves them on the same barrier
+static void contended_phases() {
+  wait_for_barrier();
+  locked_increments();
+  wait_for_barrier();
+  atomic_increments();
+  wait_for_barrier();
+}
+
+void main2() {
+  contended_phases();
+}
+
+void main3() {
+  contended_phases();
+}
+
+//! \brief  Checks the l.cas semantics atomic.h relies on, on CPU1 alone
+//! \return 0 when a compare-and-swap with the expected value stores the new one and one with
+//!         another value leaves the word alone, both returning the previous word
+static int atomic_self_test() {
+  volatile uint32_t *word = SELF_TEST_WORD;
+  int failures = 0;
+  *word = 0x1234;
+  uint32_t seen = atomic_compare_exchange(word, 0x1234, 0x5678);   // succeeds
+  if ((seen != 0x1234) || (*word != 0x5678)) {
+    printf("l.cas success case: returned %08X, word %08X (expected 00001234, 00005678)\n", seen, *word);
+    failures++;
+  }
+  seen = atomic_compare_exchange(word, 0x1234, 0x9ABC);            // fails, word holds 0x5678
+  if ((seen != 0x5678) || (*word != 0x5678)) {
+    printf("l.cas failure case: returned %08X, word %08X (expected 00005678, 00005678)\n", seen, *word);
+    failures++;
+  }
+  seen = atomic_fetch_add(word, 2);
+  if ((seen != 0x5678) || (*word != 0x567A)) {
+    printf("fetch_add: returned %08X, word %08X (expected 00005678, 0000567A)\n", seen, *word);
+    failures++;
+  }
+  *word = 0;
+  return failures;
+}
+
+static void print_result(const char *desc, perf_cycles_t cycles, uint32_t count, uint32_t expected) {
+  printf("%-24s : %lld cycles, %lld cycles/op, count %u (%s)\n", desc, cycles,
+         cycles / expected, count, (count == expected) ? "ok" : "WRONG");
+}
+
+int main() {
+  perf_cycles_t t0, t1, t2;
+
+  vga_clear();
+  printf("Lock vs. l.cas atomic contention benchmark\n");
+  perf_init();
+  perf_start();
+  init_locks();
+  init_atomics();
+
+  /* The contention phases only mean something if l.cas behaves as atomic.h assumes */
+  if (atomic_self_test()) {
+    printf("l.cas self-test FAILED, skipping the benchmark\n");
+    perf_stop();
+    return 0;
+  }
+  printf("l.cas self-test ok\n");
+
+  /* Uncontended: CPU1 alone */
+  t0 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  locked_increments();
+  t1 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  atomic_increments();
+  t2 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  print_result("lock, 1 cpu", t1 - t0, *LOCKED_COUNTER, NR_OF_INCREMENTS);
+  print_result("atomic, 1 cpu", t2 - t1, *ATOMIC_COUNTER, NR_OF_INCREMENTS);
+
+  /* Contended: all three CPUs hammer the same word */
+  *LOCKED_COUNTER = 0;
+  *ATOMIC_COUNTER = 0;
+  set_stack_cpu2(CPU2_STACK_OFFSET);
+  SET_CPU2_MAIN(&init_cpu2);
+  START_CPU2();
+  set_stack_cpu3(CPU3_STACK_OFFSET);
+  SET_CPU3_MAIN(&init_cpu3);
+  START_CPU3();
+
+  wait_for_barrier();
+  t0 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  locked_increments();
+  wait_for_barrier();
+  t1 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  atomic_increments();
+  wait_for_barrier();
+  t2 = perf_read_counter(PERF_COUNTER_RUNTIME);
+  print_result("lock, 3 cpus", t1 - t0, *LOCKED_COUNTER, NR_OF_CPUS * NR_OF_INCREMENTS);
+  print_result("atomic, 3 cpus", t2 - t1, *ATOMIC_COUNTER, NR_OF_CPUS * NR_OF_INCREMENTS);
+
+  perf_stop();
+  printf("Done\n");
+}
@@ -0,0 +1,71 @@
+#ifndef ATOMIC_INCLUDE_H
+#define ATOMIC_INCLUDE_H
+
+#include <defs.h>
+#include <stdint.h>
+#include <locks.h>
+
+/**
+ * @brief The atomic words live in the internal SSRAM right after the lock area
+ *
+ */
+#define ATOMICS_START_ADDRESS (LOCKS_START_ADDRESS + NR_OF_LOCKS)
+#define NR_OF_ATOMICS 64
+
+/**
+ * @brief Pointer to the atomic word `id` (0 <= id < NR_OF_ATOMICS)
+ *
+ */
+#define ATOMIC_WORD(id) (((volatile uint32_t *) ATOMICS_START_ADDRESS) + (id))
+
+/**
+ * @brief This routine clears the atomic words in the internal SSRAM and should only be called once
+ *
+ */
+void init_atomics();
+
+/**
+ * @brief Atomically replaces *ptr by desired if it holds expected
+ * returns the value *ptr held before the operation, the swap happened if it equals expected
+ *
+ * l.cas compares the word at [ptr] with the contents of its destination register,
+ * stores desired when they match and hands back the previous word in the same register.
+ * atomicBench checks both the success and the failure case on one CPU before it measures.
+ *
+ */
+__static_inline uint32_t atomic_compare_exchange(volatile uint32_t *ptr, uint32_t expected, uint32_t desired) {
+    uint32_t old = expected;
+    asm volatile ("l.cas %[inout1],%[in1],%[in2],0":[inout1]"+r"(old):
+                  [in1]"r"(ptr),[in2]"r"(desired):"memory");
+    return old;
+}
+
+/**
+ * @brief Atomically stores value in *ptr
+ * returns the previous value of *ptr
+ *
+ */
+__static_inline uint32_t atomic_exchange(volatile uint32_t *ptr, uint32_t value) {
+    uint32_t old, seen = *ptr;
+    do {
+        old = seen;
+        seen = atomic_compare_exchange(ptr, old, value);
+    } while (seen != old);
+    return old;
+}
+
+/**
+ * @brief Atomically adds value to *ptr
+ * returns the value of *ptr before the addition
+ *
+ */
+__static_inline uint32_t atomic_fetch_add(volatile uint32_t *ptr, uint32_t value) {
+    uint32_t old, seen = *ptr;
+    do {
+        old = seen;
+        seen = atomic_compare_exchange(ptr, old, old + value);
+    } while (seen != old);
+    return old;
+}
+
+#endif /* ATOMIC_INCLUDE_H */
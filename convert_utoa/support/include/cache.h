@@ -28,6 +28,10 @@ extern "C" {
 #define CACHE_SIZE_4K (((uint32_t)2) << 30)
 #define CACHE_SIZE_8K (((uint32_t)3) << 30)
 
+// Alignment that keeps data written by different CPUs in different cache lines, a multiple of
+// the line size (the stride sweep of memBench shows the line size)
+#define CACHE_LINE_ALIGN 64
+
 #define CACHE_SPR_ENABLE 17
 #define CACHE_SPR_ICACHE 6
 #define CACHE_SPR_DCACHE 5
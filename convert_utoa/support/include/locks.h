@@ -3,7 +3,7 @@
 
 #include <stdint.h>
 
-#define LOCKS_START_ADDRESS 0xE0000000;
+#define LOCKS_START_ADDRESS 0xE0000000
 #define NR_OF_LOCKS 256
 
 /**
@@ -0,0 +1,66 @@
+#include <dma.h>
+#include <platform.h>
+
+static dma_desc_t *chain_current = NULL;
+static uint32_t chain_status = 0;
+
+void dma_start(void *mem, void *spm, uint32_t size, uint32_t direction) {
+    dma_write_register(MEMORY_ADDRESS_ID, (uint32_t) mem);
+    dma_write_register(SPM_ADDRESS_ID, (uint32_t) spm - SPM_BASE);
+    dma_write_register(TRANSFER_SIZE_ID, size);
+    dma_write_register(START_STATUS_ID, direction);
+    // Until BUSY is up the status still reads idle and dma_wait would return at once. A
+    // transfer that is done (or rejected) before the first poll never shows BUSY, hence the bound.
+    for (unsigned poll = 0; poll < DMA_START_POLLS; poll++) {
+        if (dma_busy()) break;
+    }
+}
+
+uint32_t dma_wait() {
+    uint32_t status;
+    while ((status = dma_status()) & DMA_BUSY_BIT)
+        asm volatile("l.nop");
+    return status & DMA_ERROR_MASK;
+}
+
+static void chain_start_current() {
+    dma_start(chain_current->mem, chain_current->spm, chain_current->size, chain_current->direction);
+}
+
+void dma_chain_start(dma_desc_t *first) {
+    chain_current = first;
+    chain_status = 0;
+    if (chain_current) chain_start_current();
+}
+
+dma_desc_t *dma_chain_poll() {
+    if (chain_current == NULL) return NULL;
+    uint32_t status = dma_status();
+    if (status & DMA_BUSY_BIT) return chain_current;
+    if (status & DMA_ERROR_MASK) {
+        chain_status = status & DMA_ERROR_MASK;
+        chain_current = NULL;
+        return NULL;
+    }
+    chain_current = chain_current->next;
+    if (chain_current) chain_start_current();
+    return chain_current;
+}
+
+uint32_t dma_chain_wait() {
+    while (dma_chain_poll() != NULL)
+        asm volatile("l.nop");
+    return chain_status;
+}
+
+uint32_t dma_chain_error() {
+    return chain_status;
+}
+
+const char *dma_error_string(uint32_t status) {
+    if (status & DMA_MEM_ALLIGN_ERROR_BIT) return "memory address not word aligned";
+    if (status & DMA_SPM_ALLIGN_ERROR_BIT) return "spm address not word aligned";
+    if (status & DMA_SPM_OUT_OF_RANGE_ERROR_BIT) return "spm address out of range";
+    if (status & DMA_ERROR_BIT) return "transfer error";
+    return "ok";
+}
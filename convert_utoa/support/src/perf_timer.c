@@ -0,0 +1,23 @@
+#include <perf_timer.h>
+#include <stdio.h>
+
+void perf_timer_start(perf_timer_t *timer) {
+    timer->cycles = 0;
+    timer->start = perf_read_counter(PERF_COUNTER_RUNTIME);
+}
+
+//! Prints cycles / count with one decimal
+static void print_cycles_per(perf_cycles_t cycles, uint32_t count, const char *unit) {
+    if (count == 0) return;
+    perf_cycles_t tenths = (cycles * 10 + count / 2) / count;
+    printf(", %lld.%lld cycles/%s", tenths / 10, tenths % 10, unit);
+}
+
+void perf_timer_report(const perf_timer_t *timer, const char *desc, uint32_t n_pixels, uint32_t n_iterations) {
+    desc = desc ? desc : "no desc";
+    perf_time_t t = perf_cycles_to_time(timer->cycles);
+    printf("%-32s : %lld cycles, %02u:%02u:%02u.%03u", desc, timer->cycles, t.h, t.m, t.s, t.ms);
+    print_cycles_per(timer->cycles, n_pixels, "pixel");
+    print_cycles_per(timer->cycles, n_iterations, "iteration");
+    printf("\n");
+}
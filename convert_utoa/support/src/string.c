@@ -8,96 +8,179 @@
  * sizeof(word) MUST BE A POWER OF TWO
  * SO THAT wmask BELOW IS ALL ONES
  */
-typedef int word; /* "word" used for optimal copy speed */
+typedef uint32_t __attribute__((may_alias)) word; /* "word" used for optimal copy speed */
 
 #define wsize sizeof(word)
 #define wmask (wsize - 1)
 
 /*
- * Copy a block of memory, handling overlap.
- * This is the routine that actually implements
- * (the portable versions of) bcopy, memcpy, and memmove.
+ * Below this length the byte loops are faster than aligning the operands.
  */
-void* memcpy(void* dst0, const void* src0, size_t length) {
-    volatile char* dst = dst0;
-    const char* src = src0;
+#define SMALL_LENGTH (4 * wsize)
+
+/*
+ * Keeps gcc from recognizing the loops below as memcpy/memset and calling
+ * them recursively (the pointers used to be volatile for this).
+ */
+#define __no_libcall __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+/*
+ * Word of the source bytes at an offset of sh (1..3) bytes into the aligned
+ * word lo, continued in the next aligned word hi.
+ */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MERGE(lo, hi, sh) (((lo) << (8 * (sh))) | ((hi) >> (32 - 8 * (sh))))
+#else
+#define MERGE(lo, hi, sh) (((lo) >> (8 * (sh))) | ((hi) << (32 - 8 * (sh))))
+#endif
+
+/*
+ * Copy forward: bytes up to a word aligned dst, whole words stored aligned
+ * (4x unrolled when src is aligned too, merged from two aligned loads when
+ * it is not), then the trailing bytes. Each source word is loaded before a
+ * store can overwrite it when dst < src, which memmove relies on.
+ */
+static __no_libcall void copy_forward(char* dst, const char* src, size_t length) {
+    size_t t;
+
+    if (length < SMALL_LENGTH) {
+        while (length--) *dst++ = *src++;
+        return;
+    }
+    t = (wsize - ((uintptr_t)dst & wmask)) & wmask;
+    length -= t;
+    while (t--) *dst++ = *src++;
+
+    word* d = (word*)dst;
+    t = length / wsize;
+    uintptr_t sh = (uintptr_t)src & wmask;
+    if (sh == 0) {
+        const word* s = (const word*)src;
+        for (; t >= 4; t -= 4) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+            d[3] = s[3];
+            d += 4;
+            s += 4;
+        }
+        while (t--) *d++ = *s++;
+    } else {
+        const word* s = (const word*)(src - sh);
+        word lo = *s++;
+        while (t--) {
+            word hi = *s++;
+            *d++ = MERGE(lo, hi, sh);
+            lo = hi;
+        }
+    }
+    dst = (char*)d;
+    src += (length & ~wmask);
+    t = length & wmask;
+    while (t--) *dst++ = *src++;
+}
+
+/*
+ * Copy backwards, the mirror image of copy_forward: safe when dst > src.
+ */
+static __no_libcall void copy_backward(char* dst, const char* src, size_t length) {
     size_t t;
 
-    if (length == 0 || dst == src) /* nothing to do */
-        goto done;
-
-        /*
-         * Macros: loop-t-times; and loop-t-times, t>0
-         */
-#define TLOOP(s) \
-    if (t)       \
-    TLOOP1(s)
-#define TLOOP1(s) \
-    do {          \
-        s;        \
-    } while (--t)
-
-    if ((unsigned long)dst < (unsigned long)src) {
-        /*
-         * Copy forward.
-         */
-        t = (uintptr_t)src; /* only need low bits */
-        if ((t | (uintptr_t)dst) & wmask) {
-            /*
-             * Try to align operands.  This cannot be done
-             * unless the low bits match.
-             */
-            if ((t ^ (uintptr_t)dst) & wmask || length < wsize)
-                t = length;
-            else
-                t = wsize - (t & wmask);
-            length -= t;
-            TLOOP1(*dst++ = *src++);
+    src += length;
+    dst += length;
+    if (length < SMALL_LENGTH) {
+        while (length--) *--dst = *--src;
+        return;
+    }
+    t = (uintptr_t)dst & wmask;
+    length -= t;
+    while (t--) *--dst = *--src;
+
+    word* d = (word*)dst;
+    t = length / wsize;
+    uintptr_t sh = (uintptr_t)src & wmask;
+    if (sh == 0) {
+        const word* s = (const word*)src;
+        for (; t >= 4; t -= 4) {
+            d -= 4;
+            s -= 4;
+            d[3] = s[3];
+            d[2] = s[2];
+            d[1] = s[1];
+            d[0] = s[0];
         }
-        /*
-         * Copy whole words, then mop up any trailing bytes.
-         */
-        t = length / wsize;
-        TLOOP(*(word*)dst = *(word*)src; src += wsize; dst += wsize);
-        t = length & wmask;
-        TLOOP(*dst++ = *src++);
+        while (t--) *--d = *--s;
     } else {
-        /*
-         * Copy backwards.  Otherwise essentially the same.
-         * Alignment works as before, except that it takes
-         * (t&wmask) bytes to align, not wsize-(t&wmask).
-         */
-        src += length;
-        dst += length;
-        t = (uintptr_t)src;
-        if ((t | (uintptr_t)dst) & wmask) {
-            if ((t ^ (uintptr_t)dst) & wmask || length <= wsize)
-                t = length;
-            else
-                t &= wmask;
-            length -= t;
-            TLOOP1(*--dst = *--src);
+        const word* s = (const word*)(src - sh);
+        word hi = *s;
+        while (t--) {
+            word lo = *--s;
+            *--d = MERGE(lo, hi, sh);
+            hi = lo;
         }
-        t = length / wsize;
-        TLOOP(src -= wsize; dst -= wsize; *(word*)dst = *(word*)src);
-        t = length & wmask;
-        TLOOP(*--dst = *--src);
     }
-done:
+    dst = (char*)d;
+    src -= (length & ~wmask);
+    t = length & wmask;
+    while (t--) *--dst = *--src;
+}
+
+/*
+ * Copy a block of memory, the blocks must not overlap.
+ */
+void* memcpy(void* dst0, const void* src0, size_t length) {
+    if (length != 0 && dst0 != src0)
+        copy_forward(dst0, src0, length);
     return (dst0);
 }
 
+/*
+ * Copy a block of memory, handling overlap.
+ */
 void* memmove(void* s1, const void* s2, size_t n) {
-    return memcpy(s1, s2, n);
+    char* dst = s1;
+    const char* src = s2;
+
+    if (n == 0 || dst == src) /* nothing to do */
+        return s1;
+    if ((uintptr_t)dst - (uintptr_t)src >= n)
+        copy_forward(dst, src, n); /* dst before src, or no overlap */
+    else
+        copy_backward(dst, src, n);
+    return s1;
 }
 
 void bcopy(const void* s1, void* s2, size_t n) {
-    memcpy(s2, s1, n);
+    memmove(s2, s1, n);
 }
 
-void* memset(void* dest, register int val, register size_t len) {
-    volatile unsigned char* ptr = (unsigned char*)dest;
-    while (len-- > 0)
-        *ptr++ = val;
+__no_libcall void* memset(void* dest, register int val, register size_t len) {
+    unsigned char* ptr = (unsigned char*)dest;
+    size_t t;
+
+    if (len < SMALL_LENGTH) {
+        while (len--) *ptr++ = val;
+        return dest;
+    }
+    t = (wsize - ((uintptr_t)ptr & wmask)) & wmask;
+    len -= t;
+    while (t--) *ptr++ = val;
+
+    word w = (unsigned char)val;
+    w |= w << 8;
+    w |= w << 16;
+    word* d = (word*)ptr;
+    for (t = len / wsize; t >= 4; t -= 4) {
+        d[0] = w;
+        d[1] = w;
+        d[2] = w;
+        d[3] = w;
+        d += 4;
+    }
+    while (t--) *d++ = w;
+
+    ptr = (unsigned char*)d;
+    t = len & wmask;
+    while (t--) *ptr++ = val;
     return dest;
 }
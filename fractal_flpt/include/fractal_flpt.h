@@ -3,13 +3,6 @@
 
 #include <stdint.h>
 #include <stdio.h>
-typedef struct
-{
-  int8_t hours;
-  int8_t minutes;
-  int8_t seconds;
-} Time;
-
 //! Colour type (5-bit red, 6-bit green, 5-bit blue)
 typedef uint16_t rgb565;
 
@@ -24,12 +17,31 @@ typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_bw(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max);
+
+//! \brief Fill lut[0 .. n_max] with the colours of i2c_p, e.g. to recolour a frame
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max);
+
+//! \brief Colour an iteration buffer through a palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut);
+
+//! \brief Compute the number of iterations of every pixel into ibuf
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       float cx_0, float cy_0, float delta, uint16_t n_max);
 
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   float cx_0, float cy_0, float delta, uint16_t n_max);
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time);
+//! \brief draw_fractal specialized for one kernel and colour map (draw_fractal_<kernel>_<palette>)
+void draw_fractal_mandelbrot_bw(rgb565 *fbuf, int width, int height, float cx_0, float cy_0, float delta, uint16_t n_max);
+void draw_fractal_mandelbrot_grayscale(rgb565 *fbuf, int width, int height, float cx_0, float cy_0, float delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour(rgb565 *fbuf, int width, int height, float cx_0, float cy_0, float delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour1(rgb565 *fbuf, int width, int height, float cx_0, float cy_0, float delta, uint16_t n_max);
+
+//! \brief Mariani-Silver renderer, returns the number of pixels it computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     float cx_0, float cy_0, float delta, uint16_t n_max);
+
 #endif // FRACTAL_FLPT_H
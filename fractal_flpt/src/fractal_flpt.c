@@ -1,17 +1,60 @@
 #include "fractal_flpt.h"
-#include <rtc.h>
+#include <perf_timer.h>
+#include <profile.h>
+#include <defs.h>
 #include <swap.h>
+#include <string.h>
+
+// Skip the iteration loop for points inside the main cardioid or the period-2 bulb
+#ifndef MANDELBROT_CARDIOID_CHECK
+#define MANDELBROT_CARDIOID_CHECK    1
+#endif
+// Stop iterating as soon as the orbit runs into a cycle (it will then never escape)
+#ifndef MANDELBROT_PERIODICITY_CHECK
+#define MANDELBROT_PERIODICITY_CHECK 1
+#endif
+#define MANDELBROT_PERIOD_START      8       // first checkpoint interval, doubled at each checkpoint
+
+
+//! \brief  Test whether c lies inside the main cardioid or the period-2 bulb
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \return       1 if (cx, cy) is known to be part of the Mandelbrot set
+static int in_cardioid_or_bulb(float cx, float cy) {
+  float yy = cy * cy;
+  // period-2 bulb: (x + 1)^2 + y^2 < 1/16
+  float x_plus_one = cx + 1;
+  if (x_plus_one * x_plus_one + yy < 0.0625f) {
+    return 1;
+  }
+  // main cardioid: q (q + x - 1/4) < y^2 / 4 with q = (x - 1/4)^2 + y^2
+  float x_minus_quarter = cx - 0.25f;
+  float q = x_minus_quarter * x_minus_quarter + yy;
+  return q * (q + x_minus_quarter) < 0.25f * yy;
+}
+
 
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max) {
+__static_inline uint16_t calc_mandelbrot_point_soft_inline(float cx, float cy, uint16_t n_max) {
+#if MANDELBROT_CARDIOID_CHECK
+  if (in_cardioid_or_bulb(cx, cy)) {
+    return n_max;
+  }
+#endif
   float x = cx;
   float y = cy;
   uint16_t n = 0;
   float xx, yy, two_xy;
+#if MANDELBROT_PERIODICITY_CHECK
+  float x_old = x;
+  float y_old = y;
+  uint16_t period_len = MANDELBROT_PERIOD_START;
+  uint16_t period_pos = 0;
+#endif
   do {
     xx = x * x;
     yy = y * y;
@@ -20,28 +63,50 @@ uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max) {
     x = xx - yy + cx;
     y = two_xy + cy;
     ++n;
+#if MANDELBROT_PERIODICITY_CHECK
+    // A repeated point (that did not escape) means the orbit is caught in a cycle
+    if ((x == x_old) && (y == y_old) && ((xx + yy) < 4)) {
+      return n_max;
+    }
+    if (++period_pos == period_len) {
+      period_pos = 0;
+      period_len <<= 1;
+      x_old = x;
+      y_old = y;
+    }
+#endif
   } while (((xx + yy) < 4) && (n < n_max));
   return n;
 }
 
+//! \brief  Function pointer form of calc_mandelbrot_point_soft_inline
+uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max) {
+  return calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+}
+
 
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_bw_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
   return 0xffff;
 }
 
+//! \brief  Function pointer form of iter_to_bw_inline
+rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+  return iter_to_bw_inline(iter, n_max);
+}
+
 
 //! \brief  Map number of performed iterations to grayscale
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_grayscale_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -49,6 +114,11 @@ rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   return swap_u16(((brightness << 12) | ((brightness << 7) | brightness<<1)));
 }
 
+//! \brief  Function pointer form of iter_to_grayscale_inline
+rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+  return iter_to_grayscale_inline(iter, n_max);
+}
+
 
 //! \brief Calculate binary logarithm for unsigned integer argument x
 //! \note  For x equal 0, the function returns -1.
@@ -68,7 +138,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_colour_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -79,7 +149,12 @@ rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0x1f) << 11) | ((g & 0x1f) << 6) | ((b & 0x1f)));
 }
 
-rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+//! \brief  Function pointer form of iter_to_colour_inline
+rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour_inline(iter, n_max);
+}
+
+__static_inline rgb565 iter_to_colour1_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -90,6 +165,117 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0xf) << 12) | ((g & 0xf) << 7) | ((b & 0xf)<<1));
 }
 
+//! \brief  Function pointer form of iter_to_colour1_inline
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour1_inline(iter, n_max);
+}
+
+// Compute only one side of the real axis and mirror the rows of the other side. Only the float
+// version mirrors: the float kernel gives exactly the same counts for cy and -cy, the fixed point
+// and myfloat kernels do not.
+#ifndef FRACTAL_MIRROR
+#define FRACTAL_MIRROR 1
+#endif
+
+//! \brief  y-coordinates of the rows, accumulated as the renderers step through them
+//! \param  cy_table y-coordinate of every row
+//! \param  height   number of rows
+//! \param  cy_0     start y-coordinate
+//! \param  delta    increment for y-coordinate
+static void fractal_cy_table(float *cy_table, int height, float cy_0, float delta) {
+  float cy = cy_0;
+  for (int k = 0; k < height; ++k) {
+    cy_table[k] = cy;
+    cy += delta;
+  }
+}
+
+//! \brief  Find an already computed row whose cy is the exact negative of the cy of row k
+//! \param  k        row to be drawn, rows are drawn in increasing order
+//! \param  mirror   last row with cy <= 0, updated (-1 before the first row)
+//! \param  cy_table y-coordinates built by fractal_cy_table
+//! \return          row to copy, -1 if row k has to be computed
+static int fractal_mirror_row(int k, int *mirror, const float *cy_table) {
+#if FRACTAL_MIRROR
+  if (cy_table[k] > 0) {
+    while ((*mirror >= 0) && (cy_table[*mirror] > -cy_table[k])) {
+      --*mirror;
+    }
+    if ((*mirror >= 0) && (cy_table[*mirror] == -cy_table[k])) {
+      return *mirror;
+    }
+  } else {
+    *mirror = k;
+  }
+#endif
+  return -1;
+}
+
+//! \brief  Compute the number of iterations of every pixel
+//! \param  ibuf   iteration buffer of width * height entries
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+//! \note   Rows whose cy is the exact negative of an already computed row are copied
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       float cx_0, float cy_0, float delta, uint16_t n_max) {
+  float cy_table[height];
+  fractal_cy_table(cy_table, height, cy_0, delta);
+  int mirror = -1;
+  for (int k = 0; k < height; ++k) {
+    uint16_t *iter = ibuf + k * width;
+    int source = fractal_mirror_row(k, &mirror, cy_table);
+    if (source >= 0) {
+      memcpy(iter, ibuf + source * width, width * sizeof(uint16_t));
+      continue;
+    }
+    float cx = cx_0;
+    for(int i = 0; i < width; ++i) {
+      *(iter++) = (*cfp_p)(cx, cy_table[k], n_max);
+      cx += delta;
+    }
+  }
+}
+
+//! \brief  Tabulate a colour map for every possible number of iterations
+//! \param  lut    palette of n_max + 1 entries
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  n_max  maximum number of iterations
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max) {
+  for (uint32_t iter = 0; iter <= n_max; ++iter) {
+    lut[iter] = (*i2c_p)(iter, n_max);
+  }
+}
+
+//! \brief  Colour an iteration buffer through a palette
+//! \param  fbuf     frame buffer, may be the same memory as ibuf
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+//! \param  lut      palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut) {
+  for (int p = 0; p < n_pixels; ++p) {
+    fbuf[p] = lut[ibuf[p]];
+  }
+}
+
+//! \brief  Sum of the iteration counts of a frame, left out of the frame time
+//! \param  timer    running frame timer, paused while summing
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+static uint32_t frame_iterations(perf_timer_t *timer, const uint16_t *ibuf, int n_pixels) {
+  perf_timer_pause(timer);
+  uint32_t n_iterations = 0;
+  for (int p = 0; p < n_pixels; ++p) {
+    n_iterations += ibuf[p];
+  }
+  perf_timer_resume(timer);
+  return n_iterations;
+}
+
 //! \brief  Draw fractal into frame buffer
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
@@ -99,31 +285,165 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
+//! \note   The iteration counts are computed into fbuf first and then coloured in place
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   float cx_0, float cy_0, float delta, uint16_t n_max) {
-  Time start, end;
-  readTime(&start);
-  rgb565 *pixel = fbuf;
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  PROFILE_BEGIN("draw_fractal");
+  rgb565 lut[n_max + 1];
+  PROFILE_BEGIN("build_palette");
+  build_palette(lut, i2c_p, n_max);
+  PROFILE_END();
+  // Iterations and the stores of the counts into the frame buffer
+  PROFILE_BEGIN("draw_fractal_iter");
+  draw_fractal_iter((uint16_t *) fbuf, width, height, cfp_p, cx_0, cy_0, delta, n_max);
+  PROFILE_END();
+  uint32_t n_iterations = frame_iterations(&timer, (uint16_t *) fbuf, width * height);
+  // Loads of the counts and palette, stores of the colours
+  PROFILE_BEGIN("colour_fractal");
+  colour_fractal(fbuf, (uint16_t *) fbuf, width * height, lut);
+  PROFILE_END();
+  PROFILE_END();
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal", width * height, n_iterations);
+}
+
+//! \brief  Iteration counts of a row with the Mandelbrot kernel inlined
+__static_inline void calc_mandelbrot_row_inline(uint16_t *iter, int width, float cx, float cy,
+                                                float delta, uint16_t n_max) {
+  for (int i = 0; i < width; ++i) {
+    iter[i] = calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+    cx += delta;
+  }
+}
+
+//! \brief  Define draw_fractal_<name>, draw_fractal with the kernel and the colour map inlined
+//! \param  calc_row  inline function computing the iteration counts of a row
+//! \param  i2c       inline function mapping number of iterations to colour
+//! \note   Every row is computed into the frame buffer and coloured in place while it is cached
+#define DEFINE_FRACTAL_RENDERER(name, calc_row, i2c)                             \
+void draw_fractal_##name(rgb565 *fbuf, int width, int height,                    \
+                         float cx_0, float cy_0, float delta, uint16_t n_max) {  \
+  float cy_table[height];                                                        \
+  fractal_cy_table(cy_table, height, cy_0, delta);                               \
+  int mirror = -1;                                                               \
+  for (int k = 0; k < height; ++k) {                                             \
+    rgb565 *pixel = fbuf + k * width;                                            \
+    int source = fractal_mirror_row(k, &mirror, cy_table);                       \
+    if (source >= 0) {                                                           \
+      memcpy(pixel, fbuf + source * width, width * sizeof(rgb565));              \
+      continue;                                                                  \
+    }                                                                            \
+    calc_row((uint16_t *) pixel, width, cx_0, cy_table[k], delta, n_max);        \
+    for (int i = 0; i < width; ++i) {                                            \
+      pixel[i] = i2c(pixel[i], n_max);                                           \
+    }                                                                            \
+  }                                                                              \
+}
+
+DEFINE_FRACTAL_RENDERER(mandelbrot_bw, calc_mandelbrot_row_inline, iter_to_bw_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_grayscale, calc_mandelbrot_row_inline, iter_to_grayscale_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour, calc_mandelbrot_row_inline, iter_to_colour_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour1, calc_mandelbrot_row_inline, iter_to_colour1_inline)
+
+//! Rectangles with a side of at most MS_MIN_SIZE pixels are computed instead of subdivided
+#define MS_MIN_SIZE 4
+
+//! \brief State of a Mariani-Silver frame, fbuf holds iteration counts until the colour pass
+typedef struct
+{
+  uint16_t *iter;           // iteration count per pixel, 0 when not computed yet
+  int width;
+  const float *cx;          // x-coordinate per column
+  const float *cy;          // y-coordinate per row
+  calc_frac_point_p cfp_p;
+  uint16_t n_max;
+  int n_computed;           // number of pixels actually evaluated
+} ms_frame;
+
+//! \brief  Iteration count of pixel (i, k), evaluated on first use
+static uint16_t ms_point(ms_frame *frame, int i, int k) {
+  uint16_t *iter = &frame->iter[k * frame->width + i];
+  if (*iter == 0) {
+    *iter = (*frame->cfp_p)(frame->cx[i], frame->cy[k], frame->n_max);
+    ++frame->n_computed;
+  }
+  return *iter;
+}
+
+//! \brief  Fill the rectangle (x0, y0) - (x1, y1) (corners included)
+//! \note   If the whole border has the same iteration count the interior gets that count,
+//!         otherwise the rectangle is split along its longer side
+static void ms_rect(ms_frame *frame, int x0, int y0, int x1, int y1) {
+  uint16_t n_iter = ms_point(frame, x0, y0);
+  int uniform = 1;
+  for (int i = x0; i <= x1; ++i) {
+    uniform &= (ms_point(frame, i, y0) == n_iter);
+    uniform &= (ms_point(frame, i, y1) == n_iter);
+  }
+  for (int k = y0 + 1; k < y1; ++k) {
+    uniform &= (ms_point(frame, x0, k) == n_iter);
+    uniform &= (ms_point(frame, x1, k) == n_iter);
+  }
+  if (uniform) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      uint16_t *iter = &frame->iter[k * frame->width];
+      for (int i = x0 + 1; i < x1; ++i) {
+        iter[i] = n_iter;
+      }
+    }
+  } else if ((x1 - x0 <= MS_MIN_SIZE) || (y1 - y0 <= MS_MIN_SIZE)) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      for (int i = x0 + 1; i < x1; ++i) {
+        ms_point(frame, i, k);
+      }
+    }
+  } else if (x1 - x0 >= y1 - y0) {
+    int xm = (x0 + x1) / 2;
+    ms_rect(frame, x0, y0, xm, y1);
+    ms_rect(frame, xm, y0, x1, y1);
+  } else {
+    int ym = (y0 + y1) / 2;
+    ms_rect(frame, x0, y0, x1, ym);
+    ms_rect(frame, x0, ym, x1, y1);
+  }
+}
+
+//! \brief  Draw fractal into frame buffer by Mariani-Silver rectangle subdivision
+//! \note   Same parameters as draw_fractal. Rectangles whose border has a single
+//!         iteration count are filled without evaluating their interior.
+//! \return        number of pixels whose iteration count was computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     float cx_0, float cy_0, float delta, uint16_t n_max) {
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  // Coordinates are accumulated exactly like draw_fractal does
+  float cx_table[width];
+  float cy_table[height];
+  float cx = cx_0;
+  for (int i = 0; i < width; ++i) {
+    cx_table[i] = cx;
+    cx += delta;
+  }
   float cy = cy_0;
   for (int k = 0; k < height; ++k) {
-    float cx = cx_0;
-    for(int i = 0; i < width; ++i) {
-      uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
-      rgb565 colour = (*i2c_p)(n_iter, n_max);
-      *(pixel++) = colour;
-      cx += delta;
-    }
+    cy_table[k] = cy;
     cy += delta;
   }
-  readTime(&end);
-  printf("run time : %02X:%02X:%02X\n", end.hours - start.hours, end.minutes - start.minutes, end.seconds - start.seconds);
+  ms_frame frame = { (uint16_t *) fbuf, width, cx_table, cy_table, cfp_p, n_max, 0 };
+  for (int p = 0; p < width * height; ++p) {
+    frame.iter[p] = 0;
+  }
+  ms_rect(&frame, 0, 0, width - 1, height - 1);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  uint32_t n_iterations = frame_iterations(&timer, frame.iter, width * height);
+  colour_fractal(fbuf, frame.iter, width * height, lut);
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_ms", width * height, n_iterations);
+  return frame.n_computed;
 }
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time) {
-  time->hours = readRtcRegister(2);   
-  time->minutes = readRtcRegister(1); 
-  time->seconds = readRtcRegister(0); 
-}
\ No newline at end of file
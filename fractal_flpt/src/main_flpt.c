@@ -2,8 +2,11 @@
 #include "swap.h"
 #include "vga.h"
 #include "cache.h"
+#include <cache_tune.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <perf.h>
+#include <profile.h>
 
 // Constants describing the output device
 const int SCREEN_WIDTH = 512;   //!< screen width
@@ -15,6 +18,25 @@ const float CX_0 = -2.0;      //!< default start x-coordinate (-2.0 in Q4.28)
 const float CY_0 = -1;//-1.5;      //!< default start y-coordinate (-1.5 in Q4.28)
 const uint16_t N_MAX = 64;    //!< maximum number of iterations
 
+// Cache configurations enabled at startup, e.g. the ones found with make CACHE_TUNE=1
+#ifndef ICACHE_CFG
+#define ICACHE_CFG (CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO)
+#endif
+#ifndef DCACHE_CFG
+#define DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK)
+#endif
+
+#ifdef CACHE_TUNE
+#define TUNE_SIZE 128   //!< width and height of the frame of the tuning workload
+
+//! \brief  Tuning workload: iteration counts of the default view in a TUNE_SIZE x TUNE_SIZE frame
+//! \param  arg frame buffer of at least TUNE_SIZE x TUNE_SIZE pixels
+static void tune_workload(void *arg) {
+   draw_fractal_iter((uint16_t *) arg, TUNE_SIZE, TUNE_SIZE, &calc_mandelbrot_point_soft,
+                     CX_0, CY_0, (FRAC_WIDTH / TUNE_SIZE), N_MAX);
+}
+#endif
+
 int main() {
    volatile unsigned int *vga = (unsigned int *) 0x50000020;
    volatile unsigned int reg, hi;
@@ -23,12 +45,20 @@ int main() {
    int i;
    vga_clear();
    printf("Starting drawing a fractal\n");
-#ifdef OR1300   
+   /* start the performance counters once, the frame timers and the benches only read them */
+   perf_init();
+   perf_start();
+#ifdef __OR1300__
+#ifdef CACHE_TUNE
+   /* time the cache configurations and keep the fastest enabled */
+   cache_tune(&tune_workload, frameBuffer, ICACHE_CFG, DCACHE_CFG, 2);
+#else
    /* enable the caches */
-   icache_write_cfg( CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO );
-   dcache_write_cfg( CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK );
+   icache_write_cfg( ICACHE_CFG );
+   dcache_write_cfg( DCACHE_CFG );
    icache_enable(1);
    dcache_enable(1);
+#endif
 #endif
    /* Enable the vga-controller's graphic mode */
    vga[0] = swap_u32(SCREEN_WIDTH);
@@ -38,6 +68,10 @@ int main() {
    /* Clear screen */
    for (i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
 
+#ifdef FRACTAL_RENDERER
+   /* Specialized renderer selected in the makefile (RENDERER=...) */
+   FRACTAL_RENDERER(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0,CY_0,delta,N_MAX);
+#else
    //draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
    float cx = CX_0;
    for(int i = 0; i < (SCREEN_WIDTH/16); ++i) {
@@ -45,8 +79,49 @@ int main() {
       cx += delta;
       printf("number of iterations %d\n", n_iter);
    }
+#endif
+
+#ifdef TEST_MODE
+   // Specialized renderer: cycles per pixel of the function pointer API and of the inlined variant
+   printf("************* SPECIALIZED RENDERER BENCH TEST *************\n");
+   const int n_pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+   uint32_t checksum_generic = 0, checksum_inlined = 0;
+   perf_cycles_t generic_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   perf_cycles_t generic_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - generic_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_generic += frameBuffer[i];
+   perf_cycles_t inlined_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_mandelbrot_colour(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0,CY_0,delta,N_MAX);
+   perf_cycles_t inlined_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - inlined_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_inlined += frameBuffer[i];
+   printf("function pointers : %lld cycles/pixel (checksum %08X)\n", generic_cycles / n_pixels, checksum_generic);
+   printf("inlined           : %lld cycles/pixel (checksum %08X)\n", inlined_cycles / n_pixels, checksum_inlined);
+
+   // Mariani-Silver subdivision: pixels evaluated out of the frame, the cycles are reported by
+   // draw_fractal_ms
+   printf("************* MARIANI-SILVER BENCH TEST *************\n");
+   int n_computed = draw_fractal_ms(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   printf("computed %d of %d pixels\n", n_computed, n_pixels);
+#endif
    
-#ifdef OR1300   
+#ifdef PROFILE
+   // Where the cycles of draw_fractal go, CSV for host/profile_table.py; the ten events take
+   // two passes over the eight counters
+   printf("************* DRAW_FRACTAL PROFILE *************\n");
+   const uint32_t profile_events[] = {
+      PERF_EXECUTED_INSTRUCTIONS_MASK, PERF_STALL_CYCLES_MASK, PERF_BRANCH_PENALTY_MASK,
+      PERF_ICACHE_MISS_MASK, PERF_DCACHE_MISS_MASK, PERF_DCACHE_WRITE_BACK_MASK,
+      PERF_DCACHE_CACHE_READ_MASK, PERF_DCACHE_CACHE_WRITE_MASK,
+      PERF_DCACHE_UNCACHE_WRITE_MASK, PERF_BUS_IDLE_MASK
+   };
+   profile_init(profile_events, sizeof(profile_events) / sizeof(profile_events[0]));
+   do {
+      draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   } while (profile_next_pass());
+   profile_report_csv();
+#endif
+
+#ifdef __OR1300__
    dcache_flush();
 #endif
    printf("Done\n");
@@ -0,0 +1,57 @@
+// IMPORTANT: The caches can only be used in the OR1300 system!
+
+#ifndef CACHE_TUNE_H_INCLUDED
+#define CACHE_TUNE_H_INCLUDED
+
+#include <defs.h>
+#include <cache.h>
+#include <perf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_TUNE_MAX_CONFIGS 56   // 4 sizes x (dm + 2 x 3 policies) x 2 write policies
+
+/**
+ * @brief Work timed with each cache configuration; it has to do the same work on every call.
+ *
+ */
+typedef void (*cache_tune_workload_t)(void *arg);
+
+typedef struct {
+    uint32_t icache_cfg;
+    uint32_t dcache_cfg;
+    perf_cycles_t cycles;   // fastest run of the workload with this configuration
+} cache_tune_result_t;
+
+/**
+ * @brief Flushes both caches and enables them with the given configurations.
+ *
+ */
+void cache_configure(uint32_t icache_cfg, uint32_t dcache_cfg);
+
+/**
+ * @brief Sweeps the cache configurations (size, associativity, replacement and, for the D-cache,
+ * write policy) around a workload and leaves the fastest one enabled.
+ *
+ * Starting from the given configurations, the D-cache is swept first with the I-cache fixed, then
+ * the I-cache with the best D-cache, which takes 84 configurations instead of the 1568 of every
+ * pair. Each configuration runs the workload runs times, the first run after the flush included.
+ * Prints one line per configuration and the make variables that apply the best one at startup.
+ *
+ */
+cache_tune_result_t cache_tune(cache_tune_workload_t workload, void *arg,
+                               uint32_t icache_cfg, uint32_t dcache_cfg, unsigned runs);
+
+/**
+ * @brief Prints a configuration in short form, e.g. "8k 4-way lru wb".
+ *
+ */
+void cache_print_cfg(uint32_t cfg, int dcache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_TUNE_H_INCLUDED */
@@ -1,6 +1,9 @@
 #ifndef __DMA_H__
 #define __DMA_H__
 
+#include <defs.h>
+#include <swap.h>
+
 #define DMA_BASE_ADDRESS 0x50000040
 
 #define MEMORY_ADDRESS_ID 0
@@ -8,8 +11,8 @@
 #define TRANSFER_SIZE_ID 2
 #define START_STATUS_ID 3
 
-#define DMA_FROM_SPM_TO_MEM 1 << 8
-#define DMA_FROM_MEM_TO_SPM 1 << 9
+#define DMA_FROM_SPM_TO_MEM (1 << 8)
+#define DMA_FROM_MEM_TO_SPM (1 << 9)
 
 #define DMA_BUSY_BIT 1
 #define DMA_ERROR_BIT 2
@@ -17,4 +20,115 @@
 #define DMA_SPM_ALLIGN_ERROR_BIT 8
 #define DMA_SPM_OUT_OF_RANGE_ERROR_BIT 16
 
+#define DMA_ERROR_MASK (DMA_ERROR_BIT | DMA_MEM_ALLIGN_ERROR_BIT | DMA_SPM_ALLIGN_ERROR_BIT | DMA_SPM_OUT_OF_RANGE_ERROR_BIT)
+
+// Status polls dma_start waits at most for DMA_BUSY_BIT to show up after the start write
+#define DMA_START_POLLS 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The DMA copies between the SDRAM and the scratch-pad memory (SPM) while the CPU runs on. It
+ * does not snoop the D-cache: with a write-back D-cache, call dcache_flush() before a transfer
+ * from memory (to write back what the CPU stored) and before reading memory written by a
+ * transfer to it (to drop the stale lines). Nothing maps the SPM uncached, so the same holds
+ * for CPU stores to the SPM before a transfer from it, unless the D-cache is write-through
+ * while they are made (see draw_fractal_spm).
+ *
+ * Register layout the driver relies on, none of it is documented in this tree; the dma section
+ * of memBench checks the data of every transfer and is the test for it:
+ *  - the registers are little-endian words on the big-endian CPU, so they are written and read
+ *    through swap_u32, like the registers of the VGA controller on the same bus (see main);
+ *  - TRANSFER_SIZE is in bytes (a multiple of 4), not in words;
+ *  - SPM_ADDRESS is the offset into the SPM, not the CPU address at SPM_BASE;
+ *  - DMA_BUSY_BIT may only show up some cycles after the start write, and drops when the
+ *    transfer is done; the error bits are valid from then on.
+ */
+
+/**
+ * @brief One transfer of a chain. size is in bytes, spm is a CPU address in the SPM.
+ *
+ */
+typedef struct dma_desc {
+    void *mem;
+    void *spm;
+    uint32_t size;
+    uint32_t direction;     // DMA_FROM_MEM_TO_SPM or DMA_FROM_SPM_TO_MEM
+    struct dma_desc *next;  // started when this one completes, NULL ends the chain
+} dma_desc_t;
+
+__static_inline void dma_write_register(unsigned id, uint32_t value) {
+    ((volatile uint32_t *) DMA_BASE_ADDRESS)[id] = swap_u32(value);
+}
+
+__static_inline uint32_t dma_read_register(unsigned id) {
+    return swap_u32(((volatile uint32_t *) DMA_BASE_ADDRESS)[id]);
+}
+
+/**
+ * @brief Status bits of the last transfer (DMA_BUSY_BIT and the error bits).
+ *
+ */
+__static_inline uint32_t dma_status() {
+    return dma_read_register(START_STATUS_ID);
+}
+
+__static_inline int dma_busy() {
+    return dma_status() & DMA_BUSY_BIT;
+}
+
+/**
+ * @brief Starts a transfer and returns once the DMA reports it busy (or done, see
+ * DMA_START_POLLS), so that a following status poll sees the transfer; the DMA has to be idle.
+ *
+ */
+void dma_start(void *mem, void *spm, uint32_t size, uint32_t direction);
+
+/**
+ * @brief Waits for the running transfer.
+ * returns its error bits, 0 when it succeeded
+ *
+ */
+uint32_t dma_wait();
+
+/**
+ * @brief Starts the first transfer of a chain. The next ones are started by dma_chain_poll or
+ * dma_chain_wait, the descriptors have to stay valid until the chain is done.
+ *
+ */
+void dma_chain_start(dma_desc_t *first);
+
+/**
+ * @brief Starts the next transfer of the chain when the running one is complete.
+ * returns the descriptor of the running transfer, NULL when the chain is done or stopped on an
+ * error (see dma_chain_error)
+ *
+ */
+dma_desc_t *dma_chain_poll();
+
+/**
+ * @brief Runs the rest of the chain.
+ * returns the error bits of the failed transfer, 0 when all succeeded
+ *
+ */
+uint32_t dma_chain_wait();
+
+/**
+ * @brief Error bits of the transfer the chain stopped on, 0 if none failed.
+ *
+ */
+uint32_t dma_chain_error();
+
+/**
+ * @brief Description of the error bits of a status, "ok" without errors.
+ *
+ */
+const char *dma_error_string(uint32_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,59 @@
+#ifndef PERF_TIMER_H_INCLUDED
+#define PERF_TIMER_H_INCLUDED
+
+#include <defs.h>
+#include <perf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Stopwatch on the runtime counter (PERF_COUNTER_RUNTIME).
+ *
+ * A timer only reads the counter: the counters are started once, with perf_init() and
+ * perf_start() at the top of main, and keep running. Timers can therefore be nested in each
+ * other and in sections measured with perf_read_counter directly.
+ *
+ */
+typedef struct {
+    perf_cycles_t start;
+    perf_cycles_t cycles;   // cycles accumulated while running
+} perf_timer_t;
+
+/**
+ * @brief Resets the timer and starts it, the performance counters have to be running.
+ *
+ */
+void perf_timer_start(perf_timer_t *timer);
+
+/**
+ * @brief Stops the timer, e.g. to leave bookkeeping out of the measurement.
+ * returns the cycles accumulated so far
+ *
+ */
+__static_inline perf_cycles_t perf_timer_pause(perf_timer_t *timer) {
+    timer->cycles += perf_read_counter(PERF_COUNTER_RUNTIME) - timer->start;
+    return timer->cycles;
+}
+
+/**
+ * @brief Continues a paused timer.
+ *
+ */
+__static_inline void perf_timer_resume(perf_timer_t *timer) {
+    timer->start = perf_read_counter(PERF_COUNTER_RUNTIME);
+}
+
+/**
+ * @brief Prints the cycles and time of a paused timer, and the cycles per pixel and per iteration
+ * of the frame it measured (each left out when 0).
+ *
+ */
+void perf_timer_report(const perf_timer_t *timer, const char *desc, uint32_t n_pixels, uint32_t n_iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_TIMER_H_INCLUDED */
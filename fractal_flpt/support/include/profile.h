@@ -0,0 +1,68 @@
+#ifndef PROFILE_H_INCLUDED
+#define PROFILE_H_INCLUDED
+
+#include <defs.h>
+#include <perf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILE_MAX_REGIONS 32
+#define PROFILE_MAX_DEPTH 8
+#define PROFILE_MAX_EVENTS 16
+#define PROFILE_EVENT_COUNTERS 8   // PERF_COUNTER_0 .. PERF_COUNTER_7
+
+/**
+ * @brief Profiling regions are compiled in with -DPROFILE, and are empty otherwise.
+ *
+ * A region is identified by its name (compared by pointer, use string literals) and its
+ * enclosing region, the same name in two places gives two regions. The counts of a region
+ * include those of the regions nested in it.
+ *
+ */
+#ifdef PROFILE
+#define PROFILE_BEGIN(name) profile_begin(name)
+#define PROFILE_END() profile_end()
+#else
+#define PROFILE_BEGIN(name) do { } while (0)
+#define PROFILE_END() do { } while (0)
+#endif
+
+/**
+ * @brief Resets the profile and programs the first pass, the performance counters have to be
+ * running (see perf_timer.h). The events are PERF_*_MASK values (or of several). More events than counters are multiplexed over passes: the profiled code
+ * has to be run once per pass, e.g.
+ *
+ *   profile_init(events, n_events);
+ *   do {
+ *       work();
+ *   } while (profile_next_pass());
+ *   profile_report_csv();
+ *
+ */
+void profile_init(const uint32_t *events, unsigned n_events);
+
+/**
+ * @brief Programs the counters of the next pass.
+ * returns 0 when all passes are done
+ *
+ */
+int profile_next_pass();
+
+void profile_begin(const char *name);
+void profile_end();
+
+/**
+ * @brief Prints the profile as CSV between "# profile begin" and "# profile end" lines, one
+ * row per region with its calls, cycles and event counts per pass (host/profile_table.py
+ * turns it into a table).
+ *
+ */
+void profile_report_csv();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROFILE_H_INCLUDED */
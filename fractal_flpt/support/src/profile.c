@@ -0,0 +1,149 @@
+#include <assert.h>
+#include <profile.h>
+#include <stdio.h>
+
+typedef struct {
+    const char *name;
+    int parent;             // enclosing region, -1 at the top level
+    unsigned depth;
+    uint32_t calls;         // in the first pass
+    perf_cycles_t cycles;   // summed over the passes
+    perf_cycles_t counts[PROFILE_MAX_EVENTS];
+} profile_region_t;
+
+//! Counter values at the begin of an open region
+typedef struct {
+    int region;
+    perf_cycles_t cycles;
+    perf_cycles_t counts[PROFILE_EVENT_COUNTERS];
+} profile_frame_t;
+
+static profile_region_t regions[PROFILE_MAX_REGIONS];
+static profile_frame_t stack[PROFILE_MAX_DEPTH];
+static unsigned n_regions = 0, depth = 0;
+static uint32_t events[PROFILE_MAX_EVENTS];
+static unsigned n_events = 0, n_passes = 1, pass = 0;
+
+static const struct {
+    uint32_t mask;
+    const char *name;
+} event_names[] = {
+    { PERF_INSTRUCTION_FETCH_MASK, "instruction_fetch" },
+    { PERF_ICACHE_MISS_MASK, "icache_miss" },
+    { PERF_ICACHE_MISS_PENALY_MASK, "icache_miss_penalty" },
+    { PERF_ICACHE_FLUSH_PENALTY_MASH, "icache_flush_penalty" },
+    { PERF_ICACHE_NOP_INSERTION_MASK, "icache_nop_insertion" },
+    { PERF_BRANCH_PENALTY_MASK, "branch_penalty" },
+    { PERF_EXECUTED_INSTRUCTIONS_MASK, "executed_instructions" },
+    { PERF_STALL_CYCLES_MASK, "stall_cycles" },
+    { PERF_BUS_IDLE_MASK, "bus_idle" },
+    { PERF_DCACHE_UNCACHE_WRITE_MASK, "dcache_uncached_write" },
+    { PERF_DCACHE_UNCACHE_READ_MASK, "dcache_uncached_read" },
+    { PERF_DCACHE_CACHE_WRITE_MASK, "dcache_cached_write" },
+    { PERF_DCACHE_CACHE_READ_MASK, "dcache_cached_read" },
+    { PERF_DCACHE_SWAP_MASK, "dcache_swap" },
+    { PERF_DCACHE_CAS_MASK, "dcache_cas" },
+    { PERF_DCACHE_MISS_MASK, "dcache_miss" },
+    { PERF_DCACHE_WRITE_BACK_MASK, "dcache_write_back" },
+    { PERF_DCACHE_DATA_DEP_MASK, "dcache_data_dep" },
+    { PERF_DCACHE_WRITE_DEP_MASK, "dcache_write_dep" },
+    { PERF_DCACHE_PIPE_STALL_MASK, "dcache_pipe_stall" },
+    { PERF_DCACHE_INTENAL_STALL_MASK, "dcache_internal_stall" },
+    { PERF_DCACHE_WRITE_THROUGH_MASK, "dcache_write_through" },
+    { PERF_DCACHE_SNOOPY_INVAL_MASK, "dcache_snoopy_inval" },
+};
+
+//! Number of the events counted in the current pass, on counters 0 .. n - 1
+static unsigned pass_counters() {
+    unsigned left = n_events - pass * PROFILE_EVENT_COUNTERS;
+    return left < PROFILE_EVENT_COUNTERS ? left : PROFILE_EVENT_COUNTERS;
+}
+
+static void program_pass() {
+    for (unsigned c = 0; c < PROFILE_EVENT_COUNTERS; c++) {
+        unsigned e = pass * PROFILE_EVENT_COUNTERS + c;
+        perf_set_mask(c, e < n_events ? events[e] : 0);
+    }
+}
+
+void profile_init(const uint32_t *profile_events, unsigned n_profile_events) {
+    die_if_not(n_profile_events <= PROFILE_MAX_EVENTS);
+    for (unsigned e = 0; e < n_profile_events; e++) {
+        events[e] = profile_events[e];
+    }
+    n_events = n_profile_events;
+    n_passes = n_events ? (n_events + PROFILE_EVENT_COUNTERS - 1) / PROFILE_EVENT_COUNTERS : 1;
+    n_regions = 0;
+    depth = 0;
+    pass = 0;
+    program_pass();
+}
+
+int profile_next_pass() {
+    die_if_not(depth == 0);
+    if (pass + 1 >= n_passes) return 0;
+    ++pass;
+    program_pass();
+    return 1;
+}
+
+void profile_begin(const char *name) {
+    die_if_not(depth < PROFILE_MAX_DEPTH);
+    int parent = depth ? stack[depth - 1].region : -1;
+    unsigned r = 0;
+    while ((r < n_regions) && ((regions[r].name != name) || (regions[r].parent != parent))) r++;
+    if (r == n_regions) {
+        die_if_not(n_regions < PROFILE_MAX_REGIONS);
+        regions[r] = (profile_region_t) { .name = name, .parent = parent, .depth = depth };
+        ++n_regions;
+    }
+    profile_frame_t *frame = &stack[depth++];
+    frame->region = r;
+    // The runtime counter is read last here and first in profile_end, closest to the region
+    for (unsigned c = 0; c < pass_counters(); c++) {
+        frame->counts[c] = perf_read_counter(c);
+    }
+    frame->cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+}
+
+void profile_end() {
+    perf_cycles_t cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+    die_if_not(depth > 0);
+    profile_frame_t *frame = &stack[--depth];
+    profile_region_t *region = &regions[frame->region];
+    region->cycles += cycles - frame->cycles;
+    if (pass == 0) region->calls++;
+    perf_cycles_t *counts = &region->counts[pass * PROFILE_EVENT_COUNTERS];
+    for (unsigned c = 0; c < pass_counters(); c++) {
+        counts[c] += perf_read_counter(c) - frame->counts[c];
+    }
+}
+
+static void print_event_name(uint32_t mask) {
+    for (unsigned i = 0; i < sizeof(event_names) / sizeof(event_names[0]); i++) {
+        if (event_names[i].mask == mask) {
+            printf(",%s", event_names[i].name);
+            return;
+        }
+    }
+    printf(",0x%08x", mask);
+}
+
+void profile_report_csv() {
+    printf("# profile begin\n");
+    printf("id,parent,depth,region,calls,cycles");
+    for (unsigned e = 0; e < n_events; e++) {
+        print_event_name(events[e]);
+    }
+    printf("\n");
+    for (unsigned r = 0; r < n_regions; r++) {
+        const profile_region_t *region = &regions[r];
+        printf("%u,%d,%u,%s,%u,%lld", r, region->parent, region->depth, region->name, region->calls,
+               region->cycles / n_passes);
+        for (unsigned e = 0; e < n_events; e++) {
+            printf(",%lld", region->counts[e]);
+        }
+        printf("\n");
+    }
+    printf("# profile end\n");
+}
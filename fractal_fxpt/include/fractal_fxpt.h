@@ -2,14 +2,30 @@
 #define FRACTAL_FXPT_H
 
 #include <stdint.h>
+#include <defs.h>
+#include <locks.h>
+#include <atomic.h>
 
-
-typedef struct
-{
-  int8_t hours;
-  int8_t minutes;
-  int8_t seconds;
-} Time;
+// Fixed point representation 
+/*   ________________________________________________________________
+    |1 sign bit|  NUM_INT integer bits  |  NUM_FRAC fractional bits  |
+    |__________|________________________|____________________________|
+*/
+// NUM_INT can be set from the makefile (make NUM_INT=n). Every value of the iteration loop
+// must fit in the integer part, host/build/fixed_range reports the smallest NUM_INT that
+// holds a view: that split needs no saturation check and keeps the most fractional bits.
+#ifndef NUM_INT
+#define NUM_INT      6                       // Number of bits for the integer part
+#endif
+#if (NUM_INT < 3) || (NUM_INT > 8)
+#error "NUM_INT must hold the escape radius (>= 3) and keep the 24 bits of a float (<= 8)"
+#endif
+#define NUM_FRAC    (32 - NUM_INT - 1)       // Remaining bits for the fractional part (32-bit total, 1 bit for sign)
+#define INT_MASK    ((1 << NUM_INT) - 1)     // Mask for the integer part
+#define FRAC_MASK   ((1 << NUM_FRAC) - 1)    // Mask for the fractional part
+#define FIXED_SCALE (1 << NUM_FRAC)          // Scaling factor for fixed-point representation
+#define SIGN_MASK   (1 << 31)                // Sign bit mask for 32-bit
+#define MAX_FIXED_VALUE 0x7FFFFFFF           // Maximum positive fixed point value
 
 
 //! Colour type (5-bit red, 6-bit green, 5-bit blue)
@@ -23,17 +39,88 @@ typedef uint16_t (*calc_frac_point_p)(fixed cx, fixed cy, uint16_t n_max);
 
 uint16_t calc_mandelbrot_point_soft(fixed cx, fixed cy, uint16_t n_max);
 
+//! \brief Iteration counts of calc_mandelbrot_point_soft for a whole row, two pixels in flight
+void calc_mandelbrot_row_x2(uint16_t *iter, int width, fixed cx_0, fixed cy, fixed delta, uint16_t n_max);
+
 //! Pointer to function mapping iteration to colour value
 typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
 
 rgb565 iter_to_bw(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max);
+
+//! \brief Fill lut[0 .. n_max] with the colours of i2c_p, e.g. to recolour a frame
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max);
+
+//! \brief Colour an iteration buffer through a palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut);
+
+//! \brief Compute the number of iterations of every pixel into ibuf
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+
+//! \brief Move the view of a retained iteration buffer by (dx, dy) pixels, computing
+//!        only the newly exposed strips; cx_0 and cy_0 are updated
+void pan_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                      fixed *cx_0, fixed *cy_0, fixed delta, uint16_t n_max, int dx, int dy);
+
+//! \brief Pan a retained iteration buffer (see pan_fractal_iter) and colour it into fbuf
+void pan_fractal(rgb565 *fbuf, uint16_t *ibuf, int width, int height,
+                 calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                 fixed *cx_0, fixed *cy_0, fixed delta, uint16_t n_max, int dx, int dy);
 
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
 
+//! \brief draw_fractal specialized for one kernel and colour map (draw_fractal_<kernel>_<palette>)
+void draw_fractal_mandelbrot_bw(rgb565 *fbuf, int width, int height, fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+void draw_fractal_mandelbrot_grayscale(rgb565 *fbuf, int width, int height, fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour(rgb565 *fbuf, int width, int height, fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour1(rgb565 *fbuf, int width, int height, fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+
+//! \brief Mariani-Silver renderer, returns the number of pixels it computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+
+//! Lock guarding the shared row counter of the multicore renderer (FRACTAL_DISPATCH_LOCKED only)
+#define FRACTAL_LOCK_ID       0
+//! Next row to render, kept in the internal SSRAM
+#define FRACTAL_ROW_COUNTER   ATOMIC_WORD(0)
+//! Sum of the iteration counts of the frame, for the cycles per iteration
+#define FRACTAL_ITER_COUNTER  ATOMIC_WORD(1)
+//! Number of rows claimed by a CPU at a time
+#define FRACTAL_ROWS_PER_JOB  4
+
+//! \brief Frame description shared by the CPUs of the multicore renderer
+typedef struct
+{
+  rgb565 *fbuf;
+  int width;
+  int height;
+  calc_frac_point_p cfp_p;
+  const rgb565 *lut;        // palette built by build_palette
+  fixed cx_0;
+  fixed cy_0;
+  fixed delta;
+  uint16_t n_max;
+} fractal_job;
+
+void draw_fractal_mt(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+
+//! \brief Take part in one frame of draw_fractal_mt (CPU2 and CPU3)
+void draw_fractal_worker();
+
+//! \brief Draw fractal into frame buffer through double-buffered SPM tiles written back by DMA
+//! \note  Same parameters as draw_fractal
+void draw_fractal_spm(rgb565 *fbuf, int width, int height,
+                      calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                      fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max);
+
 //! \brief Calculate binary logarithm for unsigned integer argument x
 //! \note  For x equal 0, the function returns -1.
 int ilog2(unsigned x);
@@ -45,13 +132,128 @@ fixed float_to_fixed(float value);
 //! \brief  Multiply two fixed-point numbers
 //! \param  a fixed-point operand of multiplication
 //! \param  b fixed-point operand of multiplication
-fixed fixed_point_multiply(fixed a, fixed b);
+//! \note   Same result as ((int64_t) a * b) >> NUM_FRAC, but assembled from 16x16-bit partial
+//!         products (Hacker's Delight mulhs) so that no 64-bit multiply helper is called
+__static_inline fixed fixed_point_multiply(fixed a, fixed b) {
+  uint32_t a_lo = a & 0xFFFF;
+  uint32_t b_lo = b & 0xFFFF;
+  int32_t a_hi = a >> 16;
+  int32_t b_hi = b >> 16;
+  uint32_t lo_lo = a_lo * b_lo;
+  int32_t hi_lo = a_hi * (int32_t) b_lo + (int32_t) (lo_lo >> 16);
+  int32_t lo_hi = (int32_t) a_lo * b_hi + (hi_lo & 0xFFFF);
+  uint32_t hi = a_hi * b_hi + (hi_lo >> 16) + (lo_hi >> 16);  // bits 63..32 of the product
+  uint32_t lo = ((uint32_t) lo_hi << 16) | (lo_lo & 0xFFFF);   // bits 31..0 of the product
+  return (fixed) ((hi << (32 - NUM_FRAC)) | (lo >> NUM_FRAC));
+}
+
+//! \brief  Multiply two fixed-point numbers on a 64-bit product (reference implementation)
+fixed fixed_point_multiply_ref(fixed a, fixed b);
+
+// Wide fixed point representation for deep zooms
+/*   ____________________________________________________________________
+    |1 sign bit|  NUM_INT64 integer bits  |  NUM_FRAC64 fractional bits  |
+    |__________|__________________________|______________________________|
+*/
+#define NUM_INT64      4                          // Number of bits for the integer part
+#define NUM_FRAC64    (64 - NUM_INT64 - 1)        // Remaining bits for the fractional part (64-bit total, 1 bit for sign)
+#define FIXED64_SCALE ((int64_t) 1 << NUM_FRAC64) // Scaling factor for the wide fixed-point representation
+
+//! \brief Wide fixed point type, held in two 32-bit registers (limbs) on or1k
+typedef int64_t fixed64;
+
+//! \brief  Convert a fixed-point to a wide fixed-point (|value| < 2^NUM_INT64)
+__static_inline fixed64 fixed_to_fixed64(fixed value) {
+  return (fixed64) ((uint64_t) (fixed64) value << (NUM_FRAC64 - NUM_FRAC));
+}
+
+//! \brief  Convert a wide fixed-point to a fixed-point, truncating the low fractional bits
+__static_inline fixed fixed64_to_fixed(fixed64 value) {
+  return (fixed) (value >> (NUM_FRAC64 - NUM_FRAC));
+}
+
+//! \brief  Full 64-bit product of two 32-bit limbs from 16x16-bit partial products
+__static_inline uint64_t fixed64_umul32(uint32_t a, uint32_t b) {
+  uint32_t a_lo = a & 0xFFFF;
+  uint32_t b_lo = b & 0xFFFF;
+  uint32_t a_hi = a >> 16;
+  uint32_t b_hi = b >> 16;
+  uint32_t lo_lo = a_lo * b_lo;
+  uint32_t hi_lo = a_hi * b_lo;
+  uint32_t cross = (lo_lo >> 16) + (hi_lo & 0xFFFF) + a_lo * b_hi;  // cannot overflow
+  uint32_t hi = a_hi * b_hi + (hi_lo >> 16) + (cross >> 16);
+  uint32_t lo = (cross << 16) | (lo_lo & 0xFFFF);
+  return ((uint64_t) hi << 32) | lo;
+}
+
+//! \brief  Bits 63 + NUM_FRAC64 .. NUM_FRAC64 of the 128-bit product of two magnitudes
+//! \note   Four limb products; only the high half of the lowest one can reach the result
+__static_inline uint64_t fixed64_umul(uint64_t a, uint64_t b) {
+  uint32_t a_hi = a >> 32, a_lo = (uint32_t) a;
+  uint32_t b_hi = b >> 32, b_lo = (uint32_t) b;
+  uint64_t hi_hi = fixed64_umul32(a_hi, b_hi);
+  uint64_t hi_lo = fixed64_umul32(a_hi, b_lo);
+  uint64_t lo_hi = fixed64_umul32(a_lo, b_hi);
+  uint32_t lo_lo = fixed64_umul32(a_lo, b_lo) >> 32;
+  uint64_t mid = (uint64_t) lo_lo + (uint32_t) hi_lo + (uint32_t) lo_hi;  // bits 95..32
+  uint64_t top = hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (mid >> 32);    // bits 127..64
+  return (top << (64 - NUM_FRAC64)) | ((uint32_t) mid >> (NUM_FRAC64 - 32));
+}
+
+//! \brief  Square of a magnitude as fixed64_umul, the two cross products are the same
+__static_inline uint64_t fixed64_usquare(uint64_t a) {
+  uint32_t a_hi = a >> 32, a_lo = (uint32_t) a;
+  uint64_t hi_hi = fixed64_umul32(a_hi, a_hi);
+  uint64_t hi_lo = fixed64_umul32(a_hi, a_lo);
+  uint32_t lo_lo = fixed64_umul32(a_lo, a_lo) >> 32;
+  uint64_t mid = (uint64_t) lo_lo + ((uint64_t) (uint32_t) hi_lo << 1);  // bits 95..32
+  uint64_t top = hi_hi + ((hi_lo >> 32) << 1) + (mid >> 32);              // bits 127..64
+  return (top << (64 - NUM_FRAC64)) | ((uint32_t) mid >> (NUM_FRAC64 - 32));
+}
+
+//! \brief  Multiply two wide fixed-point numbers
+//! \param  a wide fixed-point operand of multiplication
+//! \param  b wide fixed-point operand of multiplication
+//! \note   The product is truncated toward zero. No 64-bit multiply helper is called.
+__static_inline fixed64 fixed64_multiply(fixed64 a, fixed64 b) {
+  uint64_t product = fixed64_umul(a < 0 ? -(uint64_t) a : (uint64_t) a,
+                                  b < 0 ? -(uint64_t) b : (uint64_t) b);
+  return ((a ^ b) < 0) ? -(fixed64) product : (fixed64) product;
+}
+
+//! \brief  Square a wide fixed-point number (three limb products instead of four)
+__static_inline fixed64 fixed64_square(fixed64 a) {
+  return (fixed64) fixed64_usquare(a < 0 ? -(uint64_t) a : (uint64_t) a);
+}
+
+//! \brief  Convert a double value to a wide fixed-point
+//! \param  value  to be converted, |value| < 2^NUM_INT64
+fixed64 double_to_fixed64(double value);
+
+//! \brief Mandelbrot point calculation in wide fixed point
+uint16_t calc_mandelbrot_point_fixed64(fixed64 cx, fixed64 cy, uint16_t n_max);
+
+//! \brief Compute the number of iterations of every pixel in wide fixed point
+void draw_fractal_iter64(uint16_t *ibuf, int width, int height,
+                         fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max);
+
+//! \brief Number of bits (32 or 64) of the narrowest fixed-point format resolving delta
+int fractal_precision(int width, int height, fixed64 delta);
+
+//! \brief Draw the Mandelbrot fractal in the narrowest fixed-point format resolving delta
+void draw_fractal_auto(rgb565 *fbuf, int width, int height, iter_to_colour_p i2c_p,
+                       fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max);
+
+//! \brief Compute the number of iterations of every pixel as offsets from one wide reference orbit
+void draw_fractal_perturb_iter(uint16_t *ibuf, int width, int height,
+                               fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max);
+
+//! \brief Draw the Mandelbrot fractal by perturbation, for views too deep for the 32-bit path
+void draw_fractal_perturb(rgb565 *fbuf, int width, int height, iter_to_colour_p i2c_p,
+                          fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max);
 
 //! \brief  Print the bits of fixed-point for debugging
 //! \param  fixed_value  to be printed
 void print_fixed_point_bits(fixed fixed_point_value);
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time);
 #endif // FRACTAL_FXPT_H
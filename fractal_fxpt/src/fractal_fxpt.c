@@ -1,8 +1,16 @@
 #include "fractal_fxpt.h"
-#include <rtc.h>
+#include <perf_timer.h>
+#include <profile.h>
 #include <swap.h>
+#include <locks.h>
+#include <barriers.h>
+#include <cache.h>
+#include <cache_tune.h>
+#include <dma.h>
+#include <platform.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 // IEEE Floating point representation 
 /*   ___________________________________________________
@@ -16,33 +24,69 @@
 #define IEEE_MANTISSA_MASK    ((1 << IEEE_MANTISSA_NUM_BIT) - 1) // Mask for mantissa 
 #define IEEE_IMPLICIT_ONE     (1 << IEEE_MANTISSA_NUM_BIT)       // 1.mantissa
 
-// Fixed point representation 
-/*   ________________________________________________________________
-    |1 sign bit|  NUM_INT integer bits  |  NUM_FRAC fractional bits  |
-    |__________|________________________|____________________________|
-*/
-#define NUM_INT      6                       // Number of bits for the integer part
-#define NUM_FRAC    (32 - NUM_INT - 1)       // Remaining bits for the fractional part (32-bit total, 1 bit for sign)
-#define INT_MASK    ((1 << NUM_INT) - 1)     // Mask for the integer part
-#define FRAC_MASK   ((1 << NUM_FRAC) - 1)    // Mask for the fractional part
-#define FIXED_SCALE (1 << NUM_FRAC)          // Scaling factor for fixed-point representation
-#define SIGN_MASK   (1 << 31)                // Sign bit mask for 32-bit
-#define MAX_FIXED_VALUE 0x7FFFFFFF           // Maximum positive fixed point value
 
 
 
+#define FIXED_ONE       FIXED_SCALE           // 1.0
+#define FIXED_QUARTER   (FIXED_SCALE >> 2)    // 0.25
+#define FIXED_SIXTEENTH (FIXED_SCALE >> 4)    // 0.0625
+
+// Skip the iteration loop for points inside the main cardioid or the period-2 bulb
+#ifndef MANDELBROT_CARDIOID_CHECK
+#define MANDELBROT_CARDIOID_CHECK    1
+#endif
+// Stop iterating as soon as the orbit runs into a cycle (it will then never escape)
+#ifndef MANDELBROT_PERIODICITY_CHECK
+#define MANDELBROT_PERIODICITY_CHECK 1
+#endif
+#define MANDELBROT_PERIOD_START      8       // first checkpoint interval, doubled at each checkpoint
+
+
+//! \brief  Test whether c lies inside the main cardioid or the period-2 bulb
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \return       1 if (cx, cy) is known to be part of the Mandelbrot set
+static int in_cardioid_or_bulb(fixed cx, fixed cy) {
+  // Both regions lie within -1.25 <= cx <= 0.375 and |cy| <= 0.65, keep the products in range
+  if ((cx < -(FIXED_ONE + FIXED_QUARTER)) || (cx > (FIXED_QUARTER + (FIXED_QUARTER >> 1))) ||
+      (cy > (FIXED_ONE - (FIXED_QUARTER + FIXED_SIXTEENTH))) || (cy < -(FIXED_ONE - (FIXED_QUARTER + FIXED_SIXTEENTH)))) {
+    return 0;
+  }
+  fixed yy = fixed_point_multiply(cy, cy);
+  // period-2 bulb: (x + 1)^2 + y^2 < 1/16
+  fixed x_plus_one = cx + FIXED_ONE;
+  if (fixed_point_multiply(x_plus_one, x_plus_one) + yy < FIXED_SIXTEENTH) {
+    return 1;
+  }
+  // main cardioid: q (q + x - 1/4) < y^2 / 4 with q = (x - 1/4)^2 + y^2
+  fixed x_minus_quarter = cx - FIXED_QUARTER;
+  fixed q = fixed_point_multiply(x_minus_quarter, x_minus_quarter) + yy;
+  return fixed_point_multiply(q, q + x_minus_quarter) < (yy >> 2);
+}
+
+
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(fixed cx, fixed cy, uint16_t n_max) {
-    
+__static_inline uint16_t calc_mandelbrot_point_soft_inline(fixed cx, fixed cy, uint16_t n_max) {
+#if MANDELBROT_CARDIOID_CHECK
+  if (in_cardioid_or_bulb(cx, cy)) {
+    return n_max;
+  }
+#endif
   fixed x = cx;
   fixed y = cy;
   uint16_t n = 0;
   fixed xx, yy, two_xy, minus_yy;
   fixed two = float_to_fixed(2.0);
+#if MANDELBROT_PERIODICITY_CHECK
+  fixed x_old = x;
+  fixed y_old = y;
+  uint16_t period_len = MANDELBROT_PERIOD_START;
+  uint16_t period_pos = 0;
+#endif
   do {
     xx = fixed_point_multiply(x, x);
     yy = fixed_point_multiply(y, y);
@@ -52,28 +96,192 @@ uint16_t calc_mandelbrot_point_soft(fixed cx, fixed cy, uint16_t n_max) {
     y = two_xy + cy;
 
     ++n;
+#if MANDELBROT_PERIODICITY_CHECK
+    // A repeated point (that did not escape) means the orbit is caught in a cycle
+    if ((x == x_old) && (y == y_old) && ((xx + yy) < float_to_fixed(4.0))) {
+      return n_max;
+    }
+    if (++period_pos == period_len) {
+      period_pos = 0;
+      period_len <<= 1;
+      x_old = x;
+      y_old = y;
+    }
+#endif
   } while (((xx + yy) < float_to_fixed(4.0)) && (n < n_max));
   return n;
 }
 
+//! \brief  Function pointer form of calc_mandelbrot_point_soft_inline
+uint16_t calc_mandelbrot_point_soft(fixed cx, fixed cy, uint16_t n_max) {
+  return calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+}
+
+
+// Compute the rows of calc_mandelbrot_point_soft two pixels at a time (calc_mandelbrot_row_x2)
+#ifndef MANDELBROT_ROW_PIPELINE
+#define MANDELBROT_ROW_PIPELINE 1
+#endif
+
+//! One pixel in flight in calc_mandelbrot_row_x2
+typedef struct
+{
+  fixed x, y;
+  fixed cx;
+  uint16_t n;
+  int idx;      // column of the pixel, -1 once the row is exhausted
+#if MANDELBROT_PERIODICITY_CHECK
+  fixed x_old, y_old;
+  uint16_t period_len, period_pos;
+#endif
+} mandel_lane;
+
+//! \brief  Load the next pixel of the row that is not known to be part of the set into a lane
+//! \param  l      lane to refill
+//! \param  iter   iteration counts of the row
+//! \param  next   next column to be loaded, advanced past the loaded pixel
+//! \note   Other parameters as for calc_mandelbrot_row_x2
+__static_inline void mandel_lane_refill(mandel_lane *l, uint16_t *iter, int *next, int width,
+                                        fixed cx_0, fixed cy, fixed delta, uint16_t n_max) {
+  while (*next < width) {
+    int i = (*next)++;
+    fixed cx = cx_0 + (fixed) i * delta;
+#if MANDELBROT_CARDIOID_CHECK
+    if (in_cardioid_or_bulb(cx, cy)) {
+      iter[i] = n_max;
+      continue;
+    }
+#endif
+    l->x = cx;
+    l->y = cy;
+    l->cx = cx;
+    l->n = 0;
+    l->idx = i;
+#if MANDELBROT_PERIODICITY_CHECK
+    l->x_old = cx;
+    l->y_old = cy;
+    l->period_len = MANDELBROT_PERIOD_START;
+    l->period_pos = 0;
+#endif
+    return;
+  }
+  l->idx = -1;
+}
+
+#if MANDELBROT_PERIODICITY_CHECK
+//! \brief  Periodicity check of calc_mandelbrot_point_soft for a lane that did not escape
+//! \return  1 if the orbit of the lane is caught in a cycle
+__static_inline int mandel_lane_in_cycle(mandel_lane *l) {
+  if ((l->x == l->x_old) && (l->y == l->y_old)) {
+    return 1;
+  }
+  if (++l->period_pos == l->period_len) {
+    l->period_pos = 0;
+    l->period_len <<= 1;
+    l->x_old = l->x;
+    l->y_old = l->y;
+  }
+  return 0;
+}
+#endif
+
+//! \brief  Mandelbrot iteration counts of one row, two pixels in flight
+//! \param  iter   iteration counts of the width pixels of the row
+//! \param  width  number of pixels
+//! \param  cx_0   x-coordinate of the first pixel
+//! \param  cy     y-coordinate of the row
+//! \param  delta  increment for x-coordinate
+//! \param  n_max  maximum number of iterations
+//! \note   The two orbits are independent, so the multiplies of one lane fill the latency of
+//!         the other. A lane that escapes is refilled with the next pixel of the row; when the
+//!         row is exhausted the remaining lane finishes alone. The counts are exactly those of
+//!         calc_mandelbrot_point_soft.
+void calc_mandelbrot_row_x2(uint16_t *iter, int width, fixed cx_0, fixed cy, fixed delta, uint16_t n_max) {
+  const fixed four = FIXED_ONE << 2;
+  int next = 0;
+  mandel_lane a, b;
+  mandel_lane_refill(&a, iter, &next, width, cx_0, cy, delta, n_max);
+  mandel_lane_refill(&b, iter, &next, width, cx_0, cy, delta, n_max);
+  while ((a.idx >= 0) && (b.idx >= 0)) {
+    fixed xx_a = fixed_point_multiply(a.x, a.x);
+    fixed xx_b = fixed_point_multiply(b.x, b.x);
+    fixed yy_a = fixed_point_multiply(a.y, a.y);
+    fixed yy_b = fixed_point_multiply(b.y, b.y);
+    // 2 * x is exact, (x << 1) gives the same bits as multiplying by 2.0
+    fixed two_xy_a = fixed_point_multiply((fixed) ((uint32_t) a.x << 1), a.y);
+    fixed two_xy_b = fixed_point_multiply((fixed) ((uint32_t) b.x << 1), b.y);
+    a.x = xx_a - yy_a + a.cx;
+    b.x = xx_b - yy_b + b.cx;
+    a.y = two_xy_a + cy;
+    b.y = two_xy_b + cy;
+    ++a.n;
+    ++b.n;
+    if (((xx_a + yy_a) >= four) || (a.n >= n_max)) {
+      iter[a.idx] = a.n;
+      mandel_lane_refill(&a, iter, &next, width, cx_0, cy, delta, n_max);
+    }
+#if MANDELBROT_PERIODICITY_CHECK
+    else if (mandel_lane_in_cycle(&a)) {
+      iter[a.idx] = n_max;
+      mandel_lane_refill(&a, iter, &next, width, cx_0, cy, delta, n_max);
+    }
+#endif
+    if (((xx_b + yy_b) >= four) || (b.n >= n_max)) {
+      iter[b.idx] = b.n;
+      mandel_lane_refill(&b, iter, &next, width, cx_0, cy, delta, n_max);
+    }
+#if MANDELBROT_PERIODICITY_CHECK
+    else if (mandel_lane_in_cycle(&b)) {
+      iter[b.idx] = n_max;
+      mandel_lane_refill(&b, iter, &next, width, cx_0, cy, delta, n_max);
+    }
+#endif
+  }
+  // Drain the last pixel in flight
+  mandel_lane *l = (a.idx >= 0) ? &a : &b;
+  while (l->idx >= 0) {
+    fixed xx = fixed_point_multiply(l->x, l->x);
+    fixed yy = fixed_point_multiply(l->y, l->y);
+    fixed two_xy = fixed_point_multiply((fixed) ((uint32_t) l->x << 1), l->y);
+    l->x = xx - yy + l->cx;
+    l->y = two_xy + cy;
+    ++l->n;
+    if (((xx + yy) >= four) || (l->n >= n_max)) {
+      iter[l->idx] = l->n;
+      l->idx = -1;
+    }
+#if MANDELBROT_PERIODICITY_CHECK
+    else if (mandel_lane_in_cycle(l)) {
+      iter[l->idx] = n_max;
+      l->idx = -1;
+    }
+#endif
+  }
+}
+
 
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_bw_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
   return 0xffff;
 }
 
+//! \brief  Function pointer form of iter_to_bw_inline
+rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+  return iter_to_bw_inline(iter, n_max);
+}
+
 
 //! \brief  Map number of performed iterations to grayscale
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_grayscale_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -81,6 +289,11 @@ rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   return swap_u16(((brightness << 12) | ((brightness << 7) | brightness<<1)));
 }
 
+//! \brief  Function pointer form of iter_to_grayscale_inline
+rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+  return iter_to_grayscale_inline(iter, n_max);
+}
+
 
 //! \brief Calculate binary logarithm for unsigned integer argument x
 //! \note  For x equal 0, the function returns -1.
@@ -100,7 +313,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_colour_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -111,7 +324,12 @@ rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0x1f) << 11) | ((g & 0x1f) << 6) | ((b & 0x1f)));
 }
 
-rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+//! \brief  Function pointer form of iter_to_colour_inline
+rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour_inline(iter, n_max);
+}
+
+__static_inline rgb565 iter_to_colour1_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -122,6 +340,145 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0xf) << 12) | ((g & 0xf) << 7) | ((b & 0xf)<<1));
 }
 
+//! \brief  Function pointer form of iter_to_colour1_inline
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour1_inline(iter, n_max);
+}
+
+//! \brief  Compute the number of iterations of the pixels in columns [x0, x1) of rows [y0, y1)
+//! \param  ibuf   iteration buffer of width * height entries
+//! \param  width  width of frame buffer
+//! \note   cx_0, cy_0, delta and n_max as for draw_fractal_iter
+static void draw_fractal_iter_rect(uint16_t *ibuf, int width, int x0, int y0, int x1, int y1,
+                                   calc_frac_point_p cfp_p, fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
+  fixed cy = cy_0 + (fixed) y0 * delta;
+  for (int k = y0; k < y1; ++k) {
+    uint16_t *iter = ibuf + k * width + x0;
+    fixed cx = cx_0 + (fixed) x0 * delta;
+#if MANDELBROT_ROW_PIPELINE
+    if (cfp_p == &calc_mandelbrot_point_soft) {
+      calc_mandelbrot_row_x2(iter, x1 - x0, cx, cy, delta, n_max);
+      cy += delta;
+      continue;
+    }
+#endif
+    for (int i = x0; i < x1; ++i) {
+      *(iter++) = (*cfp_p)(cx, cy, n_max);
+      cx += delta;
+    }
+    cy += delta;
+  }
+}
+
+//! \brief  Compute the number of iterations of every pixel
+//! \param  ibuf   iteration buffer of width * height entries
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
+  draw_fractal_iter_rect(ibuf, width, 0, 0, width, height, cfp_p, cx_0, cy_0, delta, n_max);
+}
+
+//! \brief  Move the view of a retained iteration buffer by whole pixels
+//! \param  ibuf   iteration buffer of the current view, updated to the new view
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  cx_0   start x-coordinate, moved by dx * delta
+//! \param  cy_0   start y-coordinate, moved by dy * delta
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+//! \param  dx     number of pixels to move the view right (negative: left)
+//! \param  dy     number of pixels to move the view down (negative: up)
+//! \note   Only the newly exposed strips are computed, the rest of the buffer is shifted. The
+//!         result equals a fresh draw_fractal_iter of the new view.
+void pan_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                      fixed *cx_0, fixed *cy_0, fixed delta, uint16_t n_max, int dx, int dy) {
+  *cx_0 += (fixed) dx * delta;
+  *cy_0 += (fixed) dy * delta;
+  if ((dx >= width) || (-dx >= width) || (dy >= height) || (-dy >= height)) {
+    draw_fractal_iter(ibuf, width, height, cfp_p, *cx_0, *cy_0, delta, n_max);
+    return;
+  }
+  // New pixel (i, k) is old pixel (i + dx, k + dy): one move of the whole buffer. Pixels
+  // that wrap around from a neighbouring row all lie in the exposed columns.
+  int n_pixels = width * height;
+  int offset = dy * width + dx;
+  if (offset > 0) {
+    memmove(ibuf, ibuf + offset, (n_pixels - offset) * sizeof(uint16_t));
+  } else if (offset < 0) {
+    memmove(ibuf - offset, ibuf, (n_pixels + offset) * sizeof(uint16_t));
+  }
+  // Exposed rows
+  int y0 = 0, y1 = height;
+  if (dy > 0) {
+    y1 = height - dy;
+    draw_fractal_iter_rect(ibuf, width, 0, y1, width, height, cfp_p, *cx_0, *cy_0, delta, n_max);
+  } else if (dy < 0) {
+    y0 = -dy;
+    draw_fractal_iter_rect(ibuf, width, 0, 0, width, y0, cfp_p, *cx_0, *cy_0, delta, n_max);
+  }
+  // Exposed columns of the remaining rows
+  if (dx > 0) {
+    draw_fractal_iter_rect(ibuf, width, width - dx, y0, width, y1, cfp_p, *cx_0, *cy_0, delta, n_max);
+  } else if (dx < 0) {
+    draw_fractal_iter_rect(ibuf, width, 0, y0, -dx, y1, cfp_p, *cx_0, *cy_0, delta, n_max);
+  }
+}
+
+//! \brief  Move the view by whole pixels and redraw the frame buffer
+//! \param  fbuf   frame buffer
+//! \param  ibuf   iteration buffer of the current view, retained between calls
+//! \note   Other parameters as for pan_fractal_iter and draw_fractal
+void pan_fractal(rgb565 *fbuf, uint16_t *ibuf, int width, int height,
+                 calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                 fixed *cx_0, fixed *cy_0, fixed delta, uint16_t n_max, int dx, int dy) {
+  pan_fractal_iter(ibuf, width, height, cfp_p, cx_0, cy_0, delta, n_max, dx, dy);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  colour_fractal(fbuf, ibuf, width * height, lut);
+}
+
+//! \brief  Tabulate a colour map for every possible number of iterations
+//! \param  lut    palette of n_max + 1 entries
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  n_max  maximum number of iterations
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max) {
+  for (uint32_t iter = 0; iter <= n_max; ++iter) {
+    lut[iter] = (*i2c_p)(iter, n_max);
+  }
+}
+
+//! \brief  Colour an iteration buffer through a palette
+//! \param  fbuf     frame buffer, may be the same memory as ibuf
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+//! \param  lut      palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut) {
+  for (int p = 0; p < n_pixels; ++p) {
+    fbuf[p] = lut[ibuf[p]];
+  }
+}
+
+//! \brief  Sum of the iteration counts of a frame, left out of the frame time
+//! \param  timer    running frame timer, paused while summing
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+static uint32_t frame_iterations(perf_timer_t *timer, const uint16_t *ibuf, int n_pixels) {
+  perf_timer_pause(timer);
+  uint32_t n_iterations = 0;
+  for (int p = 0; p < n_pixels; ++p) {
+    n_iterations += ibuf[p];
+  }
+  perf_timer_resume(timer);
+  return n_iterations;
+}
+
 //! \brief  Draw fractal into frame buffer
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
@@ -131,25 +488,688 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
+//! \note   The iteration counts are computed into fbuf first and then coloured in place
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
-  Time start, end;
-  readTime(&start);
-  rgb565 *pixel = fbuf;
-  fixed cy = cy_0;
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  PROFILE_BEGIN("draw_fractal");
+  rgb565 lut[n_max + 1];
+  PROFILE_BEGIN("build_palette");
+  build_palette(lut, i2c_p, n_max);
+  PROFILE_END();
+  // Iterations and the stores of the counts into the frame buffer
+  PROFILE_BEGIN("draw_fractal_iter");
+  draw_fractal_iter((uint16_t *) fbuf, width, height, cfp_p, cx_0, cy_0, delta, n_max);
+  PROFILE_END();
+  uint32_t n_iterations = frame_iterations(&timer, (uint16_t *) fbuf, width * height);
+  // Loads of the counts and palette, stores of the colours
+  PROFILE_BEGIN("colour_fractal");
+  colour_fractal(fbuf, (uint16_t *) fbuf, width * height, lut);
+  PROFILE_END();
+  PROFILE_END();
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal", width * height, n_iterations);
+}
+
+//! \brief  Iteration counts of a row with the Mandelbrot kernel inlined
+//! \note   Parameters as for calc_mandelbrot_row_x2
+__static_inline void calc_mandelbrot_row_inline(uint16_t *iter, int width, fixed cx, fixed cy,
+                                                fixed delta, uint16_t n_max) {
+#if MANDELBROT_ROW_PIPELINE
+  calc_mandelbrot_row_x2(iter, width, cx, cy, delta, n_max);
+#else
+  for (int i = 0; i < width; ++i) {
+    iter[i] = calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+    cx += delta;
+  }
+#endif
+}
+
+//! \brief  Define draw_fractal_<name>, draw_fractal with the kernel and the colour map inlined
+//! \param  calc_row  inline function computing the iteration counts of a row
+//! \param  i2c       inline function mapping number of iterations to colour
+//! \note   Every row is computed into the frame buffer and coloured in place while it is cached
+#define DEFINE_FRACTAL_RENDERER(name, calc_row, i2c)                                       \
+void draw_fractal_##name(rgb565 *fbuf, int width, int height,                               \
+                         fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {            \
+  for (int k = 0; k < height; ++k) {                                                       \
+    rgb565 *pixel = fbuf + k * width;                                                      \
+    calc_row((uint16_t *) pixel, width, cx_0, cy_0 + (fixed) k * delta, delta, n_max);      \
+    for (int i = 0; i < width; ++i) {                                                      \
+      pixel[i] = i2c(pixel[i], n_max);                                                     \
+    }                                                                                      \
+  }                                                                                        \
+}
+
+DEFINE_FRACTAL_RENDERER(mandelbrot_bw, calc_mandelbrot_row_inline, iter_to_bw_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_grayscale, calc_mandelbrot_row_inline, iter_to_grayscale_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour, calc_mandelbrot_row_inline, iter_to_colour_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour1, calc_mandelbrot_row_inline, iter_to_colour1_inline)
+
+#define FIXED64_ONE     FIXED64_SCALE          // 1.0
+#define FIXED64_QUARTER (FIXED64_SCALE >> 2)   // 0.25
+#define FIXED64_TWO     (FIXED64_SCALE << 1)   // 2.0
+#define FIXED64_FOUR    (FIXED64_SCALE << 2)   // 4.0
+
+//! \brief  Test whether c lies inside the main cardioid or the period-2 bulb, in wide fixed point
+//! \note   Same test as in_cardioid_or_bulb
+static int in_cardioid_or_bulb64(fixed64 cx, fixed64 cy) {
+  if ((cx < -(FIXED64_ONE + FIXED64_QUARTER)) || (cx > (FIXED64_QUARTER + (FIXED64_QUARTER >> 1))) ||
+      (cy > (FIXED64_ONE - (FIXED64_QUARTER + (FIXED64_QUARTER >> 2)))) ||
+      (cy < -(FIXED64_ONE - (FIXED64_QUARTER + (FIXED64_QUARTER >> 2))))) {
+    return 0;
+  }
+  fixed64 yy = fixed64_square(cy);
+  if (fixed64_square(cx + FIXED64_ONE) + yy < (FIXED64_QUARTER >> 2)) {
+    return 1;
+  }
+  fixed64 x_minus_quarter = cx - FIXED64_QUARTER;
+  fixed64 q = fixed64_square(x_minus_quarter) + yy;
+  return fixed64_multiply(q, q + x_minus_quarter) < (yy >> 2);
+}
+
+//! \brief  Mandelbrot fractal point calculation function in wide fixed point
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \param  n_max maximum number of iterations
+//! \return       number of performed iterations at coordinate (cx, cy), as calc_mandelbrot_point_soft
+//! \note   Q4.59 only holds |x|, |y| < 16: an orbit with |x| >= 2 or |y| >= 2 has escaped
+//!         and is stopped before its squares are formed
+uint16_t calc_mandelbrot_point_fixed64(fixed64 cx, fixed64 cy, uint16_t n_max) {
+#if MANDELBROT_CARDIOID_CHECK
+  if (in_cardioid_or_bulb64(cx, cy)) {
+    return n_max;
+  }
+#endif
+  fixed64 x = cx;
+  fixed64 y = cy;
+  uint16_t n = 0;
+  fixed64 xx, yy, xy;
+#if MANDELBROT_PERIODICITY_CHECK
+  fixed64 x_old = x;
+  fixed64 y_old = y;
+  uint16_t period_len = MANDELBROT_PERIOD_START;
+  uint16_t period_pos = 0;
+#endif
+  do {
+    ++n;
+    if ((x >= FIXED64_TWO) || (x <= -FIXED64_TWO) || (y >= FIXED64_TWO) || (y <= -FIXED64_TWO)) {
+      break;
+    }
+    xx = fixed64_square(x);
+    yy = fixed64_square(y);
+    xy = fixed64_multiply(x, y);
+
+    x = xx - yy + cx;
+    y = xy + xy + cy;
+
+#if MANDELBROT_PERIODICITY_CHECK
+    if ((x == x_old) && (y == y_old) && ((xx + yy) < FIXED64_FOUR)) {
+      return n_max;
+    }
+    if (++period_pos == period_len) {
+      period_pos = 0;
+      period_len <<= 1;
+      x_old = x;
+      y_old = y;
+    }
+#endif
+  } while (((xx + yy) < FIXED64_FOUR) && (n < n_max));
+  return n;
+}
+
+//! \brief  Compute the number of iterations of every pixel in wide fixed point
+//! \note   Parameters as for draw_fractal_iter. The coordinates are accumulated exactly.
+void draw_fractal_iter64(uint16_t *ibuf, int width, int height,
+                         fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max) {
+  fixed64 cy = cy_0;
   for (int k = 0; k < height; ++k) {
-    fixed cx = cx_0;
-    for(int i = 0; i < width; ++i) {
-      uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
-      rgb565 colour = (*i2c_p)(n_iter, n_max);
-      *(pixel++) = colour;
+    fixed64 cx = cx_0;
+    for (int i = 0; i < width; ++i) {
+      *(ibuf++) = calc_mandelbrot_point_fixed64(cx, cy, n_max);
       cx += delta;
     }
     cy += delta;
   }
-  readTime(&end);
-  printf("run time : %02X:%02X:%02X\n", end.hours - start.hours, end.minutes - start.minutes, end.seconds - start.seconds);
+}
+
+//! \brief  Select the number format of a view
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  delta  increment for x- and y-coordinate
+//! \return        32 if the fixed path resolves delta, 64 otherwise
+//! \note   The 32-bit renderer accumulates a truncated delta, losing up to one unit of
+//!         the last place per pixel. Over the frame this must stay below half a pixel.
+int fractal_precision(int width, int height, fixed64 delta) {
+  fixed delta_fixed = fixed64_to_fixed(delta);
+  int n_steps = (width > height) ? width : height;
+  return (delta_fixed >= 2 * n_steps) ? 32 : 64;
+}
+
+//! \brief  Draw the Mandelbrot fractal into frame buffer in the narrowest fixed-point format
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \note   Other parameters as for draw_fractal. Shallow views are drawn by draw_fractal
+//!         with calc_mandelbrot_point_soft, deep views by calc_mandelbrot_point_fixed64.
+void draw_fractal_auto(rgb565 *fbuf, int width, int height, iter_to_colour_p i2c_p,
+                       fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max) {
+  if (fractal_precision(width, height, delta) == 32) {
+    draw_fractal(fbuf, width, height, &calc_mandelbrot_point_soft, i2c_p,
+                 fixed64_to_fixed(cx_0), fixed64_to_fixed(cy_0), fixed64_to_fixed(delta), n_max);
+    return;
+  }
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  draw_fractal_iter64((uint16_t *) fbuf, width, height, cx_0, cy_0, delta, n_max);
+  uint32_t n_iterations = frame_iterations(&timer, (uint16_t *) fbuf, width * height);
+  colour_fractal(fbuf, (uint16_t *) fbuf, width * height, lut);
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_auto (Q4.59)", width * height, n_iterations);
+}
+
+//! \brief Point of the reference orbit of the perturbation renderer
+typedef struct
+{
+  fixed64 x64, y64;   // orbit point, used to rebase a pixel
+  fixed x, y;         // same point in fixed for the delta iteration
+  fixed norm;         // |x| + |y|
+  int escaped;        // fixed_escaped(x, y)
+} perturb_ref;
+
+//! \brief Offset of a pixel orbit from the reference orbit: (x, y) * 2^-exp
+//! \note  The fixed mantissas share one exponent and are kept in [1, 2) where possible
+typedef struct
+{
+  fixed x, y;
+  int exp;
+} perturb_delta;
+
+//! \brief  Binary logarithm of a 64-bit argument, -1 for x equal 0
+static int ilog2_64(uint64_t x) {
+  uint32_t hi = x >> 32;
+  return hi ? 32 + ilog2(hi) : ilog2((uint32_t) x);
+}
+
+//! \brief  Arithmetic right shift that saturates at the sign for shifts of 31 and more
+__static_inline fixed fixed_shift_right(fixed value, int shift) {
+  return value >> ((shift < 31) ? shift : 31);
+}
+
+//! \brief  Test |(x, y)| >= 2 without overflowing the squares
+__static_inline int fixed_escaped(fixed x, fixed y) {
+  return (x >= 2 * FIXED_ONE) || (x <= -2 * FIXED_ONE) || (y >= 2 * FIXED_ONE) || (y <= -2 * FIXED_ONE) ||
+         (fixed_point_multiply(x, x) + fixed_point_multiply(y, y) >= 4 * FIXED_ONE);
+}
+
+//! \brief  Mantissa of value * 2^exp in fixed
+static fixed perturb_mantissa(fixed64 value, int exp) {
+  int shift = NUM_FRAC64 - NUM_FRAC - exp;
+  if (shift >= 0) {
+    return (fixed) (value >> ((shift < 63) ? shift : 63));
+  }
+  return (fixed) ((uint64_t) value << -shift);
+}
+
+//! \brief  Wide fixed-point value of mantissa * 2^-exp
+static fixed64 perturb_value(fixed mantissa, int exp) {
+  int shift = NUM_FRAC64 - NUM_FRAC - exp;
+  if (shift >= 0) {
+    return (fixed64) ((uint64_t) (fixed64) mantissa << shift);
+  }
+  return (fixed64) mantissa >> ((-shift < 63) ? -shift : 63);
+}
+
+//! \brief  Bring the larger mantissa of d into [1, 2)
+//! \param  exp_max largest exponent, that of the pixel offset dc
+static void perturb_normalize(perturb_delta *d, int exp_max) {
+  uint32_t mag = (uint32_t) (d->x < 0 ? -d->x : d->x) | (uint32_t) (d->y < 0 ? -d->y : d->y);
+  if (mag == 0) {
+    return;
+  }
+  int shift = NUM_FRAC - ilog2(mag);
+  if (shift > exp_max - d->exp) shift = exp_max - d->exp;
+  if (shift < -d->exp) shift = -d->exp;
+  if (shift > 0) {
+    d->x = (fixed) ((uint32_t) d->x << shift);
+    d->y = (fixed) ((uint32_t) d->y << shift);
+  } else if (shift < 0) {
+    d->x >>= -shift;
+    d->y >>= -shift;
+  }
+  d->exp += shift;
+}
+
+//! \brief  Set d to the wide fixed-point offset (x, y)
+static void perturb_set(perturb_delta *d, fixed64 x, fixed64 y, int exp_max) {
+  uint64_t mag = (uint64_t) (x < 0 ? -x : x) | (uint64_t) (y < 0 ? -y : y);
+  int exp = (mag == 0) ? exp_max : NUM_FRAC64 - ilog2_64(mag);
+  if (exp > exp_max) exp = exp_max;
+  if (exp < 0) exp = 0;
+  d->x = perturb_mantissa(x, exp);
+  d->y = perturb_mantissa(y, exp);
+  d->exp = exp;
+}
+
+//! \brief  Compute the reference orbit Z_0 = 0, Z_m+1 = Z_m^2 + c in wide fixed point
+//! \param  ref   orbit of n_max + 1 points
+//! \return       index of the last point, n_max or the first point with |x| >= 2 or |y| >= 2
+static int perturb_reference(perturb_ref *ref, fixed64 cx, fixed64 cy, uint16_t n_max) {
+  fixed64 x = 0, y = 0;
+  int m = 0;
+  for (;;) {
+    ref[m].x64 = x;
+    ref[m].y64 = y;
+    ref[m].x = fixed64_to_fixed(x);
+    ref[m].y = fixed64_to_fixed(y);
+    ref[m].norm = (ref[m].x < 0 ? -ref[m].x : ref[m].x) + (ref[m].y < 0 ? -ref[m].y : ref[m].y);
+    ref[m].escaped = fixed_escaped(ref[m].x, ref[m].y);
+    if ((m == n_max) || (x >= FIXED64_TWO) || (x <= -FIXED64_TWO) || (y >= FIXED64_TWO) || (y <= -FIXED64_TWO)) {
+      return m;
+    }
+    fixed64 xx = fixed64_square(x);
+    fixed64 xy = fixed64_multiply(x, y);
+    x = xx - fixed64_square(y) + cx;
+    y = xy + xy + cy;
+    ++m;
+  }
+}
+
+//! \brief  Mandelbrot point calculation relative to a reference orbit
+//! \param  ref     reference orbit computed by perturb_reference
+//! \param  ref_len index of the last point of ref
+//! \param  dcx     mantissa of the x-offset of c from the reference point
+//! \param  dcy     mantissa of the y-offset of c from the reference point
+//! \param  dc_exp  exponent of dcx and dcy
+//! \param  n_max   maximum number of iterations
+//! \return         number of performed iterations, as calc_mandelbrot_point_soft
+//! \note   The offset d of the pixel orbit z = Z + d follows d' = 2 Z d + d^2 + dc. A glitch
+//!         (|z| < |d|: the offset has lost the precision of z) or the end of the reference orbit
+//!         rebases the pixel: d becomes z and the reference orbit restarts at Z_0 = 0.
+static uint16_t calc_mandelbrot_point_perturb(const perturb_ref *ref, int ref_len,
+                                              fixed dcx, fixed dcy, int dc_exp, uint16_t n_max) {
+  perturb_delta d = { 0, 0, dc_exp };
+  int m = 0;
+  for (uint16_t n = 1; n < n_max; ++n) {
+    const perturb_ref *z_ref = &ref[m];
+    fixed zd_x = fixed_point_multiply(z_ref->x, d.x) - fixed_point_multiply(z_ref->y, d.y);
+    fixed zd_y = fixed_point_multiply(z_ref->x, d.y) + fixed_point_multiply(z_ref->y, d.x);
+    zd_x += zd_x + fixed_shift_right(dcx, dc_exp - d.exp);
+    zd_y += zd_y + fixed_shift_right(dcy, dc_exp - d.exp);
+    if (d.exp < NUM_FRAC + 2) {
+      // d^2 is below the last place of d once d < 2^-(NUM_FRAC + 1)
+      fixed dd_x = fixed_point_multiply(d.x, d.x) - fixed_point_multiply(d.y, d.y);
+      fixed dd_y = fixed_point_multiply(d.x, d.y);
+      zd_x += dd_x >> d.exp;
+      zd_y += (dd_y + dd_y) >> d.exp;
+    }
+    d.x = zd_x;
+    d.y = zd_y;
+    perturb_normalize(&d, dc_exp);
+    z_ref = &ref[++m];
+
+    // Escape test on z at the resolution of fixed, that of the reference point while d is below it
+    fixed d_x = fixed_shift_right(d.x, d.exp);
+    fixed d_y = fixed_shift_right(d.y, d.exp);
+    if ((d_x | d_y) == 0) {
+      if (z_ref->escaped) {
+        return n;
+      }
+    } else if (fixed_escaped(z_ref->x + d_x, z_ref->y + d_y)) {
+      return n;
+    }
+
+    // |Z| > 2 |d| (with a margin for the truncation to fixed) rules out a glitch cheaply
+    fixed d_norm = (d_x < 0 ? -d_x : d_x) + (d_y < 0 ? -d_y : d_y);
+    if ((m < ref_len) && (z_ref->norm > 2 * d_norm + 4)) {
+      continue;
+    }
+    fixed64 d_x64 = perturb_value(d.x, d.exp);
+    fixed64 d_y64 = perturb_value(d.y, d.exp);
+    fixed64 x64 = z_ref->x64 + d_x64;
+    fixed64 y64 = z_ref->y64 + d_y64;
+    if ((m == ref_len) ||
+        ((x64 < 0 ? -x64 : x64) + (y64 < 0 ? -y64 : y64) < (d_x64 < 0 ? -d_x64 : d_x64) + (d_y64 < 0 ? -d_y64 : d_y64))) {
+      perturb_set(&d, x64, y64, dc_exp);
+      m = 0;
+    }
+  }
+  return n_max;
+}
+
+//! \brief  Compute the number of iterations of every pixel by perturbation of one reference orbit
+//! \note   Parameters as for draw_fractal_iter64. The reference orbit is computed in wide fixed
+//!         point at the centre pixel, every pixel iterates its offset from it in fixed mantissas
+//!         with a shared exponent.
+void draw_fractal_perturb_iter(uint16_t *ibuf, int width, int height,
+                               fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max) {
+  fixed64 half_x = (fixed64) (width / 2) * delta;
+  fixed64 half_y = (fixed64) (height / 2) * delta;
+  fixed64 ref_cx = cx_0 + half_x;
+  fixed64 ref_cy = cy_0 + half_y;
+  perturb_ref ref[n_max + 1];
+  int ref_len = perturb_reference(ref, ref_cx, ref_cy, n_max);
+  // Largest exponent for which the pixel offsets stay below 1
+  int dc_exp = NUM_FRAC64 - 1 - ilog2_64((half_x > half_y) ? half_x : half_y);
+  if (dc_exp < 0) dc_exp = 0;
+
+  fixed64 dcy = -half_y;
+  for (int k = 0; k < height; ++k) {
+    fixed64 dcx = -half_x;
+    fixed dcy_mantissa = perturb_mantissa(dcy, dc_exp);
+    for (int i = 0; i < width; ++i) {
+#if MANDELBROT_CARDIOID_CHECK
+      if (in_cardioid_or_bulb64(ref_cx + dcx, ref_cy + dcy)) {
+        *(ibuf++) = n_max;
+        dcx += delta;
+        continue;
+      }
+#endif
+      *(ibuf++) = calc_mandelbrot_point_perturb(ref, ref_len, perturb_mantissa(dcx, dc_exp), dcy_mantissa, dc_exp, n_max);
+      dcx += delta;
+    }
+    dcy += delta;
+  }
+}
+
+//! \brief  Draw the Mandelbrot fractal into frame buffer by perturbation of one reference orbit
+//! \note   Parameters as for draw_fractal_auto, see draw_fractal_perturb_iter
+void draw_fractal_perturb(rgb565 *fbuf, int width, int height, iter_to_colour_p i2c_p,
+                          fixed64 cx_0, fixed64 cy_0, fixed64 delta, uint16_t n_max) {
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  draw_fractal_perturb_iter((uint16_t *) fbuf, width, height, cx_0, cy_0, delta, n_max);
+  uint32_t n_iterations = frame_iterations(&timer, (uint16_t *) fbuf, width * height);
+  colour_fractal(fbuf, (uint16_t *) fbuf, width * height, lut);
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_perturb", width * height, n_iterations);
+}
+
+//! Rectangles with a side of at most MS_MIN_SIZE pixels are computed instead of subdivided
+#define MS_MIN_SIZE 4
+
+//! \brief State of a Mariani-Silver frame, fbuf holds iteration counts until the colour pass
+typedef struct
+{
+  uint16_t *iter;           // iteration count per pixel, 0 when not computed yet
+  int width;
+  const fixed *cx;          // x-coordinate per column
+  const fixed *cy;          // y-coordinate per row
+  calc_frac_point_p cfp_p;
+  uint16_t n_max;
+  int n_computed;           // number of pixels actually evaluated
+} ms_frame;
+
+//! \brief  Iteration count of pixel (i, k), evaluated on first use
+static uint16_t ms_point(ms_frame *frame, int i, int k) {
+  uint16_t *iter = &frame->iter[k * frame->width + i];
+  if (*iter == 0) {
+    *iter = (*frame->cfp_p)(frame->cx[i], frame->cy[k], frame->n_max);
+    ++frame->n_computed;
+  }
+  return *iter;
+}
+
+//! \brief  Fill the rectangle (x0, y0) - (x1, y1) (corners included)
+//! \note   If the whole border has the same iteration count the interior gets that count,
+//!         otherwise the rectangle is split along its longer side
+static void ms_rect(ms_frame *frame, int x0, int y0, int x1, int y1) {
+  uint16_t n_iter = ms_point(frame, x0, y0);
+  int uniform = 1;
+  for (int i = x0; i <= x1; ++i) {
+    uniform &= (ms_point(frame, i, y0) == n_iter);
+    uniform &= (ms_point(frame, i, y1) == n_iter);
+  }
+  for (int k = y0 + 1; k < y1; ++k) {
+    uniform &= (ms_point(frame, x0, k) == n_iter);
+    uniform &= (ms_point(frame, x1, k) == n_iter);
+  }
+  if (uniform) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      uint16_t *iter = &frame->iter[k * frame->width];
+      for (int i = x0 + 1; i < x1; ++i) {
+        iter[i] = n_iter;
+      }
+    }
+  } else if ((x1 - x0 <= MS_MIN_SIZE) || (y1 - y0 <= MS_MIN_SIZE)) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      for (int i = x0 + 1; i < x1; ++i) {
+        ms_point(frame, i, k);
+      }
+    }
+  } else if (x1 - x0 >= y1 - y0) {
+    int xm = (x0 + x1) / 2;
+    ms_rect(frame, x0, y0, xm, y1);
+    ms_rect(frame, xm, y0, x1, y1);
+  } else {
+    int ym = (y0 + y1) / 2;
+    ms_rect(frame, x0, y0, x1, ym);
+    ms_rect(frame, x0, ym, x1, y1);
+  }
+}
+
+//! \brief  Draw fractal into frame buffer by Mariani-Silver rectangle subdivision
+//! \note   Same parameters as draw_fractal. Rectangles whose border has a single
+//!         iteration count are filled without evaluating their interior.
+//! \return        number of pixels whose iteration count was computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  // Coordinates are accumulated exactly like draw_fractal does
+  fixed cx_table[width];
+  fixed cy_table[height];
+  fixed cx = cx_0;
+  for (int i = 0; i < width; ++i) {
+    cx_table[i] = cx;
+    cx += delta;
+  }
+  fixed cy = cy_0;
+  for (int k = 0; k < height; ++k) {
+    cy_table[k] = cy;
+    cy += delta;
+  }
+  ms_frame frame = { (uint16_t *) fbuf, width, cx_table, cy_table, cfp_p, n_max, 0 };
+  for (int p = 0; p < width * height; ++p) {
+    frame.iter[p] = 0;
+  }
+  ms_rect(&frame, 0, 0, width - 1, height - 1);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  uint32_t n_iterations = frame_iterations(&timer, frame.iter, width * height);
+  colour_fractal(fbuf, frame.iter, width * height, lut);
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_ms", width * height, n_iterations);
+  return frame.n_computed;
+}
+
+//! \brief  Colour one row: iteration counts, then the palette in place
+//! \param  pixel  first pixel of the row
+//! \param  lut    palette built by build_palette
+//! \param  cy     y-coordinate of the row
+//! \note   The other parameters as for draw_fractal
+//! \return        sum of the iteration counts of the row
+static uint32_t draw_fractal_row(rgb565 *pixel, int width, calc_frac_point_p cfp_p, const rgb565 *lut,
+                                 fixed cx_0, fixed cy, fixed delta, uint16_t n_max) {
+  uint32_t n_iterations = 0;
+#if MANDELBROT_ROW_PIPELINE
+  if (cfp_p == &calc_mandelbrot_point_soft) {
+    calc_mandelbrot_row_x2((uint16_t *) pixel, width, cx_0, cy, delta, n_max);
+    for (int i = 0; i < width; ++i) {
+      n_iterations += pixel[i];
+      pixel[i] = lut[pixel[i]];
+    }
+    return n_iterations;
+  }
+#endif
+  fixed cx = cx_0;
+  for (int i = 0; i < width; ++i) {
+    uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
+    n_iterations += n_iter;
+    pixel[i] = lut[n_iter];
+    cx += delta;
+  }
+  return n_iterations;
+}
+
+//! Frame description shared between the rendering CPUs
+static fractal_job mt_job;
+
+//! \brief  Render rows of the shared job until the row counter runs past the frame
+//! \note   Rows are claimed in bands of FRACTAL_ROWS_PER_JOB with one atomic_fetch_add,
+//!         or under FRACTAL_LOCK_ID when built with FRACTAL_DISPATCH_LOCKED
+//!         The iteration counts of the rows are added to FRACTAL_ITER_COUNTER when done
+static void draw_fractal_rows(const fractal_job *job) {
+  volatile uint32_t *next_row = FRACTAL_ROW_COUNTER;
+  uint32_t n_iterations = 0;
+  for (;;) {
+#ifdef FRACTAL_DISPATCH_LOCKED
+    get_lock(FRACTAL_LOCK_ID);
+    uint32_t row = *next_row;
+    *next_row = row + FRACTAL_ROWS_PER_JOB;
+    release_lock(FRACTAL_LOCK_ID);
+#else
+    uint32_t row = atomic_fetch_add(next_row, FRACTAL_ROWS_PER_JOB);
+#endif
+    if (row >= (uint32_t) job->height) {
+      atomic_fetch_add(FRACTAL_ITER_COUNTER, n_iterations);
+      return;
+    }
+    int row_end = row + FRACTAL_ROWS_PER_JOB;
+    if (row_end > job->height) {
+      row_end = job->height;
+    }
+    rgb565 *pixel = job->fbuf + row * job->width;
+    fixed cy = job->cy_0 + (fixed) row * job->delta;
+    for (int k = row; k < row_end; ++k) {
+      n_iterations += draw_fractal_row(pixel, job->width, job->cfp_p, job->lut, job->cx_0, cy, job->delta, job->n_max);
+      pixel += job->width;
+      cy += job->delta;
+    }
+  }
+}
+
+//! \brief  Take part in one multicore frame, to be called in a loop by main2/main3
+//! \note   Blocks on the barrier until CPU1 publishes a frame in draw_fractal_mt
+void draw_fractal_worker() {
+  wait_for_barrier();   // frame published
+  draw_fractal_rows(&mt_job);
+  wait_for_barrier();   // frame done
+}
+
+//! \brief  Draw fractal into frame buffer using CPU1, CPU2 and CPU3
+//! \note   Same parameters as draw_fractal. CPU2 and CPU3 must have been started
+//!         with a main loop calling draw_fractal_worker, and init_locks and
+//!         init_atomics must have been called once. CPU1 renders into its write-back
+//!         D-cache while the workers write to memory, so fbuf and the bands of
+//!         FRACTAL_ROWS_PER_JOB rows have to be CACHE_LINE_ALIGN aligned (a line shared by
+//!         two bands would overwrite the pixels of a worker when written back); otherwise
+//!         the frame is drawn by draw_fractal on CPU1 alone.
+void draw_fractal_mt(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
+  if ((((uintptr_t) fbuf) % CACHE_LINE_ALIGN) ||
+      ((FRACTAL_ROWS_PER_JOB * width * sizeof(rgb565)) % CACHE_LINE_ALIGN)) {
+    draw_fractal(fbuf, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+    return;
+  }
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  mt_job.fbuf = fbuf;
+  mt_job.width = width;
+  mt_job.height = height;
+  mt_job.cfp_p = cfp_p;
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  mt_job.lut = lut;
+  mt_job.cx_0 = cx_0;
+  mt_job.cy_0 = cy_0;
+  mt_job.delta = delta;
+  mt_job.n_max = n_max;
+  *FRACTAL_ROW_COUNTER = 0;
+  *FRACTAL_ITER_COUNTER = 0;
+#ifdef __OR1300__
+  // Publish the job and palette and drop dirty frame buffer lines, the workers bypass our D-cache
+  dcache_flush();
+#endif
+  wait_for_barrier();   // release the workers
+  draw_fractal_rows(&mt_job);
+  wait_for_barrier();   // join the workers
+#ifdef __OR1300__
+  // Write the rows of CPU1 back to the frame buffer
+  dcache_flush();
+#endif
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_mt", width * height, *FRACTAL_ITER_COUNTER);
+}
+
+#define SPM_TILE_BYTES  (SPM_SIZE / 2)   // each of the two tile buffers in the SPM
+
+//! \brief  Draw fractal into frame buffer through tiles in the scratch-pad memory
+//! \note   Same parameters as draw_fractal. The rows of a tile are computed and coloured in one
+//!         half of the SPM while the DMA copies the previous tile from the other half to fbuf,
+//!         so the frame buffer stores bypass the CPU and its D-cache. The SPM is not mapped
+//!         uncached, so the D-cache is write-through for the frame: the tile stores reach the
+//!         SPM as they are made and no transfer needs a flush, while the palette and the stack
+//!         stay cached for reads. Only switching the D-cache there and back flushes it.
+//!         Falls back to draw_fractal when a row does not fit in a tile buffer.
+void draw_fractal_spm(rgb565 *fbuf, int width, int height,
+                      calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                      fixed cx_0, fixed cy_0, fixed delta, uint16_t n_max) {
+  const int row_bytes = width * sizeof(rgb565);
+  const int tile_rows = SPM_TILE_BYTES / row_bytes;
+  if (tile_rows == 0) {
+    draw_fractal(fbuf, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+    return;
+  }
+  perf_timer_t timer, dma_timer = { 0, 0 };
+  perf_timer_start(&timer);
+  uint32_t n_iterations = 0;
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+#ifdef __OR1300__
+  // Write-through for the tiles; the switch also writes back and drops the frame buffer lines,
+  // the DMA writes behind the D-cache
+  const uint32_t dcache_cfg = dcache_read_cfg();
+  cache_configure(icache_read_cfg(), (dcache_cfg & ~CACHE_WRITE_BACK) | CACHE_WRITE_THROUGH);
+#endif
+  rgb565 *tile[2] = { (rgb565 *) SPM_BASE, (rgb565 *) (SPM_BASE + SPM_TILE_BYTES) };
+  fixed cy = cy_0;
+  int t = 0;
+  for (int k = 0; k < height; k += tile_rows, t ^= 1) {
+    const int rows = (height - k < tile_rows) ? height - k : tile_rows;
+    rgb565 *pixel = tile[t];
+    for (int r = 0; r < rows; ++r, pixel += width) {
+      n_iterations += draw_fractal_row(pixel, width, cfp_p, lut, cx_0, cy, delta, n_max);
+      cy += delta;
+    }
+    // The previous tile was copied out while this one was computed
+    if (k > 0) {
+      perf_timer_resume(&dma_timer);
+      uint32_t status = dma_wait();
+      perf_timer_pause(&dma_timer);
+      if (status) printf("draw_fractal_spm: dma error, %s\n", dma_error_string(status));
+    }
+    dma_start(fbuf + k * width, tile[t], rows * row_bytes, DMA_FROM_SPM_TO_MEM);
+  }
+  perf_timer_resume(&dma_timer);
+  uint32_t status = dma_wait();
+  perf_timer_pause(&dma_timer);
+  if (status) printf("draw_fractal_spm: dma error, %s\n", dma_error_string(status));
+#ifdef __OR1300__
+  cache_configure(icache_read_cfg(), dcache_cfg);
+#endif
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_spm", width * height, n_iterations);
+  perf_timer_report(&dma_timer, "draw_fractal_spm (dma waits)", 0, 0);
 }
 
 //! \brief  Convert a float value to a fixed-point
@@ -203,10 +1223,18 @@ fixed float_to_fixed(float float_value) {
   return fixed_value;
 }
 
+//! \brief  Convert a double value to a wide fixed-point
+//! \param  value  to be converted, |value| < 2^NUM_INT64
+//! \note   Only used to set up a view, the soft-float conversion is not performance critical
+fixed64 double_to_fixed64(double value) {
+  return (fixed64) (value * (double) FIXED64_SCALE);
+}
+
 //! \brief  Multiply two fixed-point numbers
 //! \param  a fixed-point operand of multiplication
 //! \param  b fixed-point operand of multiplication
-fixed fixed_point_multiply(fixed a, fixed b) {
+//! \note   Reference implementation on a 64-bit product, see the inline fixed_point_multiply
+fixed fixed_point_multiply_ref(fixed a, fixed b) {
   int64_t temp = (int64_t)a * (int64_t)b;     // cast to 64 bits as multiplication doubles the number bits needed for fixed points
   fixed result = (fixed)(temp >> NUM_FRAC);  // Shift right to scale back to 32 bits (loses precision during this operation)
   return result;
@@ -235,10 +1263,3 @@ void print_fixed_point_bits(fixed fixed_value) {
   printf("\n");
 }
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time) {
-  time->hours = readRtcRegister(2);   // Read hours
-  time->minutes = readRtcRegister(1); // Read minutes
-  time->seconds = readRtcRegister(0); // Read seconds
-}
@@ -2,31 +2,58 @@
 #include "swap.h"
 #include "vga.h"
 #include "cache.h"
+#include <cache_tune.h>
+#include "cpu2.h"
+#include "cpu3.h"
+#include "locks.h"
+#include "atomic.h"
 #include <stddef.h>
 #include <stdio.h>
-#include <rtc.h>
-
-#define NUM_INT    5                             // Number of bits for the integer part
-#define NUM_FRAC   (32 - NUM_INT - 1)            // Remaining bits for the fractional part (32-bit total, 1 bit for sign)
-#define INT_MASK   ((1 << NUM_INT) - 1)          // Mask for the integer part
-#define FRAC_MASK  ((1 << NUM_FRAC) - 1)         // Mask for the fractional part
-
-#define SIGN_MASK   (1 << 31)  // Sign bit mask for 32-bit
-#define VALUE_MASK  ((1 << NUM_FRAC) - 1)  // Mask for the value part (excluding the sign)
-#define MANTISSA_MASK ((1 << 23) - 1) 
-#define IMPLICIT_ONE (1 << 23)
-
+#include <lfsr.h>
+#include <perf.h>
+#include <profile.h>
 
 // Constants describing the output device
 const int SCREEN_WIDTH = 512;   //!< screen width
 const int SCREEN_HEIGHT = 512;  //!< screen height
 
 // Constants describing the initial view port on the fractal function
-const float FRAC_WIDTH = 3.0; //!< default fractal width (3.0 in Q4.28)
-const float CX_0 = -2.0;      //!< default start x-coordinate (-2.0 in Q4.28)
-const float CY_0 = -1.5;        //!< default start y-coordinate (-1.5 in Q4.28)
+// (converted with float_to_fixed to the Q(NUM_INT).(NUM_FRAC) format of fractal_fxpt.h)
+const float FRAC_WIDTH = 3.0; //!< default fractal width
+const float CX_0 = -2.0;      //!< default start x-coordinate
+const float CY_0 = -1.5;        //!< default start y-coordinate
 const uint16_t N_MAX = 64;    //!< maximum number of iterations
 
+// Cache configurations enabled at startup, e.g. the ones found with make CACHE_TUNE=1
+#ifndef ICACHE_CFG
+#define ICACHE_CFG (CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO)
+#endif
+#ifndef DCACHE_CFG
+#define DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK)
+#endif
+
+#ifdef CACHE_TUNE
+#define TUNE_SIZE 128   //!< width and height of the frame of the tuning workload
+
+//! \brief  Tuning workload: iteration counts of the default view in a TUNE_SIZE x TUNE_SIZE frame
+//! \param  arg frame buffer of at least TUNE_SIZE x TUNE_SIZE pixels
+static void tune_workload(void *arg) {
+   draw_fractal_iter((uint16_t *) arg, TUNE_SIZE, TUNE_SIZE, &calc_mandelbrot_point_soft,
+                     float_to_fixed(CX_0), float_to_fixed(CY_0), float_to_fixed((FRAC_WIDTH / TUNE_SIZE)), N_MAX);
+}
+#endif
+
+// Stack offsets of CPU2/CPU3 below the stack top of CPU1, which holds the 512 KB frame buffer
+#define CPU2_STACK_OFFSET 0x100000
+#define CPU3_STACK_OFFSET 0x180000
+
+void main2() {
+   while (1) draw_fractal_worker();
+}
+
+void main3() {
+   while (1) draw_fractal_worker();
+}
 
 int main() {    
 
@@ -35,7 +62,7 @@ int main() {
 
    volatile unsigned int *vga = (unsigned int *) 0x50000020;
    volatile unsigned int reg, hi;
-   rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT];
+   rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT] __attribute__((aligned(CACHE_LINE_ALIGN)));
    float delta = FRAC_WIDTH / SCREEN_WIDTH;
    // convert to fixed point 
    fixed delta_fixed = float_to_fixed(delta);
@@ -43,13 +70,21 @@ int main() {
    int i;
    vga_clear();
    printf("Starting drawing a fractal in fixed point representation\n");
+   /* start the performance counters once, the frame timers and the benches only read them */
+   perf_init();
+   perf_start();
 
-#ifdef OR1300   
+#ifdef __OR1300__
+#ifdef CACHE_TUNE
+   /* time the cache configurations and keep the fastest enabled */
+   cache_tune(&tune_workload, frameBuffer, ICACHE_CFG, DCACHE_CFG, 2);
+#else
    /* enable the caches */
-   icache_write_cfg( CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO );
-   dcache_write_cfg( CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK );
+   icache_write_cfg( ICACHE_CFG );
+   dcache_write_cfg( DCACHE_CFG );
    icache_enable(1);
    dcache_enable(1);
+#endif
 #endif
 
    /* Enable the vga-controller's graphic mode */
@@ -62,9 +97,244 @@ int main() {
    
    /* Clear screen */
    for (i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
+#if defined(FRACTAL_RENDERER)
+   /* Specialized renderer selected in the makefile (RENDERER=...) */
+   FRACTAL_RENDERER(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+#elif defined(FRACTAL_SPM_TILES)
+   /* Tiles computed in the scratch-pad and written back by DMA (SPM_TILES=1) */
+   draw_fractal_spm(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+#elif defined(FRACTAL_MULTICORE) && defined(__OR1300__)
+   /* Start CPU2 and CPU3 and render the frame on all three cores (MULTICORE=1) */
+   init_locks();
+   init_atomics();
+   set_stack_cpu2(CPU2_STACK_OFFSET);
+   SET_CPU2_MAIN(&init_cpu2);
+   START_CPU2();
+   set_stack_cpu3(CPU3_STACK_OFFSET);
+   SET_CPU3_MAIN(&init_cpu3);
+   START_CPU3();
+   draw_fractal_mt(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+#else
    draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+#endif
+
+#ifdef TEST_MODE
+   // Fixed-point multiply: bit-exactness against the 64-bit reference and cycle comparison
+   printf("************* FIXED POINT MULTIPLY BENCH TEST *************\n");
+   const fixed edge_cases[] = { 0, 1, -1, FIXED_SCALE, -FIXED_SCALE, MAX_FIXED_VALUE, -MAX_FIXED_VALUE,
+                                (fixed) SIGN_MASK, 0x0000FFFF, 0x00010000, (fixed) 0xFFFF0000, (fixed) 0x8000FFFF };
+   const int n_edge = sizeof(edge_cases) / sizeof(edge_cases[0]);
+   int mismatches = 0;
+   for (int a = 0; a < n_edge; a++) {
+      for (int b = 0; b < n_edge; b++) {
+         mismatches += fixed_point_multiply(edge_cases[a], edge_cases[b]) != fixed_point_multiply_ref(edge_cases[a], edge_cases[b]);
+      }
+   }
+   struct lfsr_fibonacci lfsr;
+   lfsr_fibonacci_init(&lfsr, 32, LFSR_UNSIGNED(0xACE1), 0);
+   const int n_random = 100000;
+   for (int t = 0; t < n_random; t++) {
+      fixed a = (fixed) lfsr_fibonacci_next(&lfsr);
+      fixed b = (fixed) lfsr_fibonacci_next(&lfsr);
+      mismatches += fixed_point_multiply(a, b) != fixed_point_multiply_ref(a, b);
+   }
+   printf("%d edge and %d random operand pairs, %d mismatches\n", n_edge * n_edge, n_random, mismatches);
+
+   // Same dependent multiply chain for both implementations, the loop overhead is included in both
+   const int n_mul = 10000;
+   volatile fixed sink;
+   fixed acc = float_to_fixed(0.999);
+   fixed factor = float_to_fixed(1.0001);
+   perf_cycles_t start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+   for (int t = 0; t < n_mul; t++) acc = fixed_point_multiply_ref(acc, factor);
+   perf_cycles_t ref_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+   sink = acc;
+   acc = float_to_fixed(0.999);
+   start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+   for (int t = 0; t < n_mul; t++) acc = fixed_point_multiply(acc, factor);
+   perf_cycles_t new_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+   sink = acc;
+   printf("64-bit product    : %lld cycles for %d multiplies\n", ref_cycles, n_mul);
+   printf("partial products  : %lld cycles for %d multiplies\n", new_cycles, n_mul);
+
+   // Two-pixel row kernel: per-pixel iteration counts against the scalar kernel, and cycles per frame
+   printf("************* TWO-PIXEL ROW KERNEL BENCH TEST *************\n");
+   uint16_t row_iter[SCREEN_WIDTH];
+   int row_mismatches = 0;
+   perf_cycles_t scalar_cycles = 0, row_cycles = 0;
+   for (int k = 0; k < SCREEN_HEIGHT; k++) {
+      fixed cy = CY_0_fixed + k * delta_fixed;
+      start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+      calc_mandelbrot_row_x2(row_iter, SCREEN_WIDTH, CX_0_fixed, cy, delta_fixed, N_MAX);
+      row_cycles += perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+      start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+      for (int i = 0; i < SCREEN_WIDTH; i++) {
+         row_mismatches += calc_mandelbrot_point_soft(CX_0_fixed + i * delta_fixed, cy, N_MAX) != row_iter[i];
+      }
+      scalar_cycles += perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+   }
+   printf("%d pixels, %d mismatches\n", SCREEN_WIDTH * SCREEN_HEIGHT, row_mismatches);
+   printf("scalar kernel     : %lld cycles\n", scalar_cycles);
+   printf("two-pixel kernel  : %lld cycles\n", row_cycles);
+
+   // Specialized renderer: cycles per pixel of the function pointer API and of the inlined variant
+   printf("************* SPECIALIZED RENDERER BENCH TEST *************\n");
+   const int n_pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+   uint32_t checksum_generic = 0, checksum_inlined = 0;
+   perf_cycles_t generic_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t generic_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - generic_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_generic += frameBuffer[i];
+   perf_cycles_t inlined_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_mandelbrot_colour(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t inlined_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - inlined_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_inlined += frameBuffer[i];
+   printf("function pointers : %lld cycles/pixel (checksum %08X)\n", generic_cycles / n_pixels, checksum_generic);
+   printf("inlined           : %lld cycles/pixel (checksum %08X)\n", inlined_cycles / n_pixels, checksum_inlined);
+
+   // Mariani-Silver subdivision: pixels evaluated out of the frame, the cycles are reported by
+   // draw_fractal_ms
+   printf("************* MARIANI-SILVER BENCH TEST *************\n");
+   int n_computed = draw_fractal_ms(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   printf("computed %d of %d pixels\n", n_computed, n_pixels);
+
+   // Panning: a retained 128 x 128 iteration buffer moved step by step against a fresh
+   // draw_fractal_iter of every view, both buffers are kept in the frame buffer
+   printf("************* PAN BENCH TEST *************\n");
+   const int pan_size = 128;
+   const int pan_steps[][2] = { { 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 17, -9 },
+                                { -40, 25 }, { 200, 0 }, { 0, -300 } };
+   uint16_t *iter_pan = (uint16_t *) frameBuffer;
+   uint16_t *iter_fresh = iter_pan + pan_size * pan_size;
+   fixed pan_delta = float_to_fixed(FRAC_WIDTH / pan_size);
+   fixed pan_cx = CX_0_fixed, pan_cy = CY_0_fixed;
+   draw_fractal_iter(iter_pan, pan_size, pan_size, &calc_mandelbrot_point_soft, pan_cx, pan_cy, pan_delta, N_MAX);
+   for (unsigned s = 0; s < sizeof(pan_steps) / sizeof(pan_steps[0]); s++) {
+      const int dx = pan_steps[s][0], dy = pan_steps[s][1];
+      perf_cycles_t pan_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+      pan_fractal_iter(iter_pan, pan_size, pan_size, &calc_mandelbrot_point_soft, &pan_cx, &pan_cy, pan_delta, N_MAX, dx, dy);
+      perf_cycles_t pan_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - pan_start;
+      perf_cycles_t fresh_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+      draw_fractal_iter(iter_fresh, pan_size, pan_size, &calc_mandelbrot_point_soft, pan_cx, pan_cy, pan_delta, N_MAX);
+      perf_cycles_t fresh_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - fresh_start;
+      int pan_mismatches = 0;
+      for (i = 0 ; i < pan_size * pan_size ; i++) pan_mismatches += iter_pan[i] != iter_fresh[i];
+      printf("pan (%4d,%4d) : %lld cycles, fresh %lld cycles, %d mismatches\n", dx, dy,
+             pan_cycles, fresh_cycles, pan_mismatches);
+   }
+
+   // Wide fixed point: square against multiply, and cycles per pixel of the automatic
+   // renderer at increasing zoom depths around a point on the boundary of the set
+   printf("************* DEEP ZOOM BENCH TEST *************\n");
+   int square_mismatches = 0;
+   for (int t = 0; t < n_random; t++) {
+      fixed64 a = ((fixed64) lfsr_fibonacci_next(&lfsr) << 32 | lfsr_fibonacci_next(&lfsr)) >> (NUM_INT64 + 1);
+      square_mismatches += fixed64_square(a) != fixed64_multiply(a, a);
+   }
+   printf("%d random squares, %d mismatches\n", n_random, square_mismatches);
+   const double zoom_cx = -0.743643887037151, zoom_cy = 0.131825904205330;
+   for (int depth = 0; depth <= 40; depth += 8) {
+      double zoom_delta = FRAC_WIDTH / (1LL << depth) / SCREEN_WIDTH;
+      fixed64 delta64 = double_to_fixed64(zoom_delta);
+      fixed64 cx64 = double_to_fixed64(zoom_cx - zoom_delta * (SCREEN_WIDTH / 2));
+      fixed64 cy64 = double_to_fixed64(zoom_cy - zoom_delta * (SCREEN_HEIGHT / 2));
+      perf_cycles_t zoom_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+      draw_fractal_auto(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&iter_to_colour,cx64,cy64,delta64,N_MAX);
+      perf_cycles_t zoom_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - zoom_start;
+      printf("zoom 2^%2d : %d-bit, %lld cycles/pixel\n", depth,
+             fractal_precision(SCREEN_WIDTH, SCREEN_HEIGHT, delta64), zoom_cycles / n_pixels);
+   }
+
+   // Perturbation: iteration counts against the wide fixed-point kernel on a 128 x 128 view,
+   // both iteration buffers are kept in the frame buffer
+   printf("************* PERTURBATION BENCH TEST *************\n");
+   const int pert_size = 128;
+   uint16_t *iter64 = (uint16_t *) frameBuffer;
+   uint16_t *iter_pert = iter64 + pert_size * pert_size;
+   for (int depth = 24; depth <= 40; depth += 8) {
+      double zoom_delta = FRAC_WIDTH / (1LL << depth) / pert_size;
+      fixed64 delta64 = double_to_fixed64(zoom_delta);
+      fixed64 cx64 = double_to_fixed64(zoom_cx - zoom_delta * (pert_size / 2));
+      fixed64 cy64 = double_to_fixed64(zoom_cy - zoom_delta * (pert_size / 2));
+      perf_cycles_t wide_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+      draw_fractal_iter64(iter64, pert_size, pert_size, cx64, cy64, delta64, N_MAX);
+      perf_cycles_t wide_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - wide_start;
+      perf_cycles_t pert_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+      draw_fractal_perturb_iter(iter_pert, pert_size, pert_size, cx64, cy64, delta64, N_MAX);
+      perf_cycles_t pert_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - pert_start;
+      int pert_mismatches = 0;
+      for (i = 0 ; i < pert_size * pert_size ; i++) pert_mismatches += iter64[i] != iter_pert[i];
+      printf("zoom 2^%2d : Q%d.%d %lld, perturbation %lld cycles/pixel, %d mismatches\n", depth,
+             NUM_INT64, NUM_FRAC64, wide_cycles / (pert_size * pert_size),
+             pert_cycles / (pert_size * pert_size), pert_mismatches);
+   }
+
+   // SPM tiles: the frame buffer written by DMA from the scratch-pad against the cached stores
+   // of draw_fractal, both must give identical frames. SPM_TILES=1 only pays off when this
+   // reports a speedup above 1.
+   printf("************* SPM TILES BENCH TEST *************\n");
+   uint32_t checksum_cached = 0, checksum_spm = 0;
+   perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
+   perf_cycles_t cached_misses = perf_read_counter(PERF_COUNTER_0);
+   perf_cycles_t cached_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t cached_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - cached_start;
+   cached_misses = perf_read_counter(PERF_COUNTER_0) - cached_misses;
+   for (i = 0 ; i < n_pixels ; i++) checksum_cached += frameBuffer[i];
+   for (i = 0 ; i < n_pixels ; i++) frameBuffer[i] = 0;   // rows the DMA does not write stay black
+   perf_cycles_t spm_misses = perf_read_counter(PERF_COUNTER_0);
+   perf_cycles_t spm_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_spm(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t spm_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - spm_start;
+   spm_misses = perf_read_counter(PERF_COUNTER_0) - spm_misses;
+   for (i = 0 ; i < n_pixels ; i++) checksum_spm += frameBuffer[i];
+   perf_cycles_t spm_speedup = (cached_cycles * 100 + spm_cycles / 2) / spm_cycles;
+   printf("cached stores     : %lld cycles/pixel, %lld D-cache misses (checksum %08X)\n",
+          cached_cycles / n_pixels, cached_misses, checksum_cached);
+   printf("spm tiles + dma   : %lld cycles/pixel, %lld D-cache misses (checksum %08X, %s)\n",
+          spm_cycles / n_pixels, spm_misses, checksum_spm, (checksum_spm == checksum_cached) ? "same" : "DIFFERENT");
+   printf("spm tiles speedup : %lld.%02lld (%s than draw_fractal)\n", spm_speedup / 100, spm_speedup % 100,
+          (spm_cycles < cached_cycles) ? "faster" : "not faster");
+
+#if defined(FRACTAL_MULTICORE) && defined(__OR1300__)
+   // Multicore: the frame on CPU1, CPU2 and CPU3 against CPU1 alone, both cache coherent at
+   // return (the speedup the three cores give, up to 3)
+   printf("************* MULTICORE BENCH TEST *************\n");
+   uint32_t checksum_single = 0, checksum_mt = 0;
+   perf_cycles_t single_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t single_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - single_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_single += frameBuffer[i];
+   for (i = 0 ; i < n_pixels ; i++) frameBuffer[i] = 0;   // rows no CPU writes stay black
+   perf_cycles_t mt_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_mt(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   perf_cycles_t mt_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - mt_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_mt += frameBuffer[i];
+   perf_cycles_t speedup = (single_cycles * 100 + mt_cycles / 2) / mt_cycles;
+   printf("1 cpu             : %lld cycles (checksum %08X)\n", single_cycles, checksum_single);
+   printf("3 cpus            : %lld cycles (checksum %08X, %s), speedup %lld.%02lld\n", mt_cycles,
+          checksum_mt, (checksum_mt == checksum_single) ? "same" : "DIFFERENT", speedup / 100, speedup % 100);
+#endif
+#endif
+
+#ifdef PROFILE
+   // Where the cycles of draw_fractal go, CSV for host/profile_table.py; the ten events take
+   // two passes over the eight counters
+   printf("************* DRAW_FRACTAL PROFILE *************\n");
+   const uint32_t profile_events[] = {
+      PERF_EXECUTED_INSTRUCTIONS_MASK, PERF_STALL_CYCLES_MASK, PERF_BRANCH_PENALTY_MASK,
+      PERF_ICACHE_MISS_MASK, PERF_DCACHE_MISS_MASK, PERF_DCACHE_WRITE_BACK_MASK,
+      PERF_DCACHE_CACHE_READ_MASK, PERF_DCACHE_CACHE_WRITE_MASK,
+      PERF_DCACHE_UNCACHE_WRITE_MASK, PERF_BUS_IDLE_MASK
+   };
+   profile_init(profile_events, sizeof(profile_events) / sizeof(profile_events[0]));
+   do {
+      draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_fixed,CY_0_fixed,delta_fixed,N_MAX);
+   } while (profile_next_pass());
+   profile_report_csv();
+#endif
 
-#ifdef OR1300   
+#ifdef __OR1300__
    dcache_flush();
 #endif
    printf("Done\n");
@@ -177,5 +177,5 @@ void set_stack_cpu3(unsigned int off) {
   asm volatile ("l.mfspr %[out1],r0,0x5005;l.nop;l.nop":[out1]"=r"(spCpu1));
   if (off > spCpu1) return;
   spCpu3 = ((spCpu1 >> 24) == 0) ? spCpu1 - off : 0xC0001FFC;
-  asm volatile("l.mtspr r0,%[in1],0x5021"::[in1]"r"(spCpu3));
+  asm volatile("l.mtspr r0,%[in1],0x5022"::[in1]"r"(spCpu3));
 }
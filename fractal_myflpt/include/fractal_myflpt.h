@@ -4,13 +4,6 @@
 #include <stdint.h>
 
 
-typedef struct
-{
-  int8_t hours;
-  int8_t minutes;
-  int8_t seconds;
-} Time;
-
 //! Colour type (5-bit red, 6-bit green, 5-bit blue)
 typedef uint16_t rgb565;
 
@@ -28,15 +21,41 @@ typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_bw(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max);
+
+//! \brief Fill lut[0 .. n_max] with the colours of i2c_p, e.g. to recolour a frame
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max);
+
+//! \brief Colour an iteration buffer through a palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut);
+
+//! \brief Compute the number of iterations of every pixel into ibuf
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
 
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
 
+//! \brief draw_fractal specialized for one kernel and colour map (draw_fractal_<kernel>_<palette>)
+void draw_fractal_mandelbrot_bw(rgb565 *fbuf, int width, int height, myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
+void draw_fractal_mandelbrot_grayscale(rgb565 *fbuf, int width, int height, myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour(rgb565 *fbuf, int width, int height, myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
+void draw_fractal_mandelbrot_colour1(rgb565 *fbuf, int width, int height, myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
+
+//! \brief Mariani-Silver renderer, returns the number of pixels it computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max);
+
 //! \brief  Convert a IEEE float value to myfloat custom representation 
 //! \param  float_value  to be converted to myfloat
 myfloat float_to_myfloat(float float_value);
 
+//! \brief  Convert a myfloat to IEEE float
+//! \param  myfloat_value  to be converted to float
+float myfloat_to_float(myfloat myfloat_value);
+
 //! \brief  add two myfloat-point numbers
 //! \param  a myfloat operand of addition
 //! \param  b myfloat operand of addition
@@ -56,9 +75,14 @@ myfloat myfloat_negate(myfloat a);
 //! \param  b myfloat operand of comparison
 uint32_t myfloat_less_than(myfloat a, myfloat b);
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time);
+//! \brief  One Mandelbrot step z = z^2 + c with a single rounding per result
+//! \param  x  real part of z, replaced by x^2 - y^2 + cx
+//! \param  y  imaginary part of z, replaced by 2xy + cy
+//! \param  cx x-coordinate
+//! \param  cy y-coordinate
+//! \return |z|^2 of the z passed in
+myfloat myfloat_mandel_step(myfloat *x, myfloat *y, myfloat cx, myfloat cy);
+
 
 void print_myfloat_bits(myfloat myfloat_value);
 void print_bits(int32_t float_value);
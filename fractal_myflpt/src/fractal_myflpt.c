@@ -1,6 +1,8 @@
 #include "fractal_myflpt.h"
+#include <perf_timer.h>
+#include <profile.h>
+#include <defs.h>
 #include <swap.h>
-#include <rtc.h>
 #include <stdio.h>
 
 
@@ -21,59 +23,469 @@
     |1 sign bit|  23 mantissa bits  |  8 exponent bits  |
     |__________|____________________|___________________|
 */
+// Order-preserving alternative, selected with MYFLOAT_ORDERED_LAYOUT (fields in the order of IEEE float)
+/*   ___________________________________________________
+    |1 sign bit|  8 exponent bits  |  23 mantissa bits  |
+    |__________|___________________|____________________|
+    Words of equal sign compare like their magnitudes, so comparisons reduce to integer compares.
+*/
+#ifndef MYFLOAT_ORDERED_LAYOUT
+#define MYFLOAT_ORDERED_LAYOUT 0
+#endif
 #define MYFLOAT_EXPONENT_NUM_BIT  8                                    // Number of bits for exponent
 #define MYFLOAT_EXPONENT_MASK    ((1 << IEEE_EXPONENT_NUM_BIT) - 1)    // Mask for exponent = 11111111b
 #define MYFLOAT_BIAS             (uint32_t) 250                     // MYFLOAT_exponent_bits = exponent_value + MYFLOAT_BIAS = IEEE_exponent_bits - IEEE_BIAS + MYFLOAT_BIAS
 #define BIAS_DIFFERENCE          (uint32_t) (MYFLOAT_BIAS - IEEE_BIAS)             // MYFLOAT_exponent_bits = IEEE_exponent_bits + BIAS_DIFFERENCE (123)
 #define MYFLOAT_MANTISSA_NUM_BIT  23                                   // Number of bits for the mantissa
-#define MYFLOAT_MANTISSA_MASK    (((1 << MYFLOAT_MANTISSA_NUM_BIT) - 1) << MYFLOAT_EXPONENT_NUM_BIT) // Mask for mantissa shifter to the level of the mantissa (bit 30 :: bit 8)
+#if MYFLOAT_ORDERED_LAYOUT
+#define MYFLOAT_EXPONENT_SHIFT    MYFLOAT_MANTISSA_NUM_BIT             // Exponent in bit 23 :: bit 30
+#define MYFLOAT_MANTISSA_SHIFT    0                                    // Mantissa in bit 0 :: bit 22
+#else
+#define MYFLOAT_EXPONENT_SHIFT    0                                    // Exponent in bit 0 :: bit 7
+#define MYFLOAT_MANTISSA_SHIFT    MYFLOAT_EXPONENT_NUM_BIT             // Mantissa in bit 8 :: bit 30
+#endif
+#define MYFLOAT_MANTISSA_MASK    (((1 << MYFLOAT_MANTISSA_NUM_BIT) - 1) << MYFLOAT_MANTISSA_SHIFT) // Mask for mantissa shifted to the level of the mantissa
 #define MYFLOAT_IMPLICIT_ONE     (1 << MYFLOAT_MANTISSA_NUM_BIT)       // 1.mantissa
 #define SIGN_MASK                (1 << 31)                             // Sign bit mask for 32-bit
 
 
+// Skip the iteration loop for points inside the main cardioid or the period-2 bulb. Off by
+// default: myfloat has no zero, so the plain kernel lets some interior points near the cusp
+// (cx = 0.25) escape, and the test would change their iteration counts.
+#ifndef MANDELBROT_CARDIOID_CHECK
+#define MANDELBROT_CARDIOID_CHECK    0
+#endif
+// Stop iterating as soon as the orbit runs into a cycle (it will then never escape)
+#ifndef MANDELBROT_PERIODICITY_CHECK
+#define MANDELBROT_PERIODICITY_CHECK 1
+#endif
+#define MANDELBROT_PERIOD_START      8       // first checkpoint interval, doubled at each checkpoint
+
+
+// Normalize after a subtraction with a leading-zero count instead of one shift per bit
+#ifndef MYFLOAT_NORMALIZE_CLZ
+#define MYFLOAT_NORMALIZE_CLZ 1
+#endif
+// The core implements l.fl1 (find last one), otherwise __builtin_clz is used
+#ifndef MYFLOAT_HAVE_FL1
+#define MYFLOAT_HAVE_FL1      0
+#endif
+
+//! \brief  Number of leading zero bits of a non-zero word
+__static_inline uint32_t myfloat_clz(uint32_t value) {
+#if MYFLOAT_HAVE_FL1
+  uint32_t last_one;  // 1-based position of the most significant one
+  asm ("l.fl1 %[out1],%[in1]":[out1]"=r"(last_one):[in1]"r"(value));
+  return 32 - last_one;
+#else
+  return __builtin_clz(value);
+#endif
+}
+
+//! \brief Unpacked myfloat, the working representation of the arithmetic
+typedef struct
+{
+  uint32_t sign;      // SIGN_MASK or 0
+  uint32_t exponent;  // biased exponent, 0 .. 255
+  uint32_t mantissa;  // 1.mantissa, the implicit one is bit 23
+} myfloat_u;
+
+//! \brief  Split a myfloat into sign, exponent and mantissa with the implicit one
+__static_inline myfloat_u myfloat_unpack(myfloat a) {
+  myfloat_u u;
+  u.sign = a & SIGN_MASK;
+  u.exponent = (a >> MYFLOAT_EXPONENT_SHIFT) & MYFLOAT_EXPONENT_MASK;
+  u.mantissa = ((a & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_MANTISSA_SHIFT) | MYFLOAT_IMPLICIT_ONE;
+  return u;
+}
+
+//! \brief  Assemble a myfloat from an unpacked value (the implicit one is dropped)
+__static_inline myfloat myfloat_pack(myfloat_u u) {
+  return u.sign | ((u.mantissa << MYFLOAT_MANTISSA_SHIFT) & MYFLOAT_MANTISSA_MASK) | (u.exponent << MYFLOAT_EXPONENT_SHIFT);
+}
+
+#if MYFLOAT_ORDERED_LAYOUT
+//! \brief  Map a myfloat to an integer of the same order (sign-magnitude to two's complement)
+__static_inline int32_t myfloat_order_key(myfloat a) {
+  return a ^ ((a >> 31) & ~SIGN_MASK);
+}
+#endif
+
+//! \brief  Compare two non-negative unpacked myfloats, e.g. |z|^2 with the escape radius
+//! \return 1 if a < b
+__static_inline uint32_t myfloat_u_positive_less_than(myfloat_u a, myfloat_u b) {
+#if MYFLOAT_ORDERED_LAYOUT
+  return myfloat_pack(a) < myfloat_pack(b);     // one integer compare
+#else
+  return (a.exponent < b.exponent) || ((a.exponent == b.exponent) && (a.mantissa < b.mantissa));
+#endif
+}
+
+//! \brief  add two unpacked myfloats
+//! \note   A result that cancels to 0 keeps the implicit one, as the packed format has no zero
+__static_inline myfloat_u myfloat_u_addition(myfloat_u a, myfloat_u b) {
+  uint8_t exponent_a = a.exponent;
+  uint8_t exponent_b = b.exponent;
+  uint32_t mantissa_a = a.mantissa;
+  uint32_t mantissa_b = b.mantissa;
+
+  // Alignement of the exponents and mantissas
+  if (exponent_a > exponent_b) {
+    mantissa_b >>= exponent_a - exponent_b;
+    exponent_b =  exponent_a;
+  } else {
+    mantissa_a >>= exponent_b - exponent_a;
+    exponent_a = exponent_b;
+  }
+
+  // Perform addition or substraction operation
+  myfloat_u result;
+  int32_t result_mantissa;
+  if (a.sign == b.sign) { // Same signs 
+    result_mantissa = mantissa_a + mantissa_b;
+    result.sign = a.sign;
+  } else {                // Different signs
+    if (mantissa_a > mantissa_b) {  // a is bigger that b
+      result_mantissa = mantissa_a - mantissa_b;
+      result.sign = a.sign;   
+    } else {                        // b is bigger than a
+      result_mantissa = mantissa_b - mantissa_a;
+      result.sign = b.sign; 
+    }
+  }
+
+  // Normalize the result
+  uint8_t result_exponent = exponent_a; // maximum exponent
+  if (result_mantissa & (1 << (MYFLOAT_MANTISSA_NUM_BIT + 1))) {// Check for mantissa overflow 
+    result_mantissa >>= 1;
+    result_exponent++;
+  }
+#if MYFLOAT_NORMALIZE_CLZ
+  if (result_mantissa != 0) { // stop if result = 0 (in case of equal substraction)
+    uint32_t shift = myfloat_clz(result_mantissa) - (31 - MYFLOAT_MANTISSA_NUM_BIT); // moves the leading one to bit 23
+    result_mantissa <<= shift;
+    result_exponent -= shift;
+  }
+#else
+  while ((result_mantissa & (1 << MYFLOAT_MANTISSA_NUM_BIT)) == 0 && result_mantissa != 0) { // while implicit one of result (bit23) is 0 and stop if result = 0 (in case of equal substraction)
+    result_mantissa <<= 1;
+    result_exponent--;
+  }
+#endif
+  result.mantissa = result_mantissa | MYFLOAT_IMPLICIT_ONE;
+  result.exponent = result_exponent;
+  return result;
+}
+
+//! \brief  multiply two unpacked myfloats
+__static_inline myfloat_u myfloat_u_multiply(myfloat_u a, myfloat_u b) {
+  myfloat_u result;
+  result.sign = a.sign ^ b.sign;  // XOR the signs to get the result's sign
+  uint8_t exponent_a = a.exponent;
+
+  // Multiply the mantissas
+  uint64_t mantissa_product = (uint64_t)a.mantissa * (uint64_t)b.mantissa;
+
+  // Normalize the mantissa result if needed
+  if (mantissa_product  >= (1ULL << (2*MYFLOAT_MANTISSA_NUM_BIT + 1))) {  // The mantissa product is greater than 2.0 in 64 bit format (becaue 2*23 = 46 bits)
+    mantissa_product >>= (MYFLOAT_MANTISSA_NUM_BIT + 1);  
+    exponent_a += 1;  // Adjust exponent for normalization
+  } else {
+    mantissa_product >>= MYFLOAT_MANTISSA_NUM_BIT;  // Normalize the product
+  }
+
+  // Add the exponents 
+  int32_t exponent_result = (int32_t)(exponent_a + b.exponent - MYFLOAT_BIAS); // because by simply adding we have 2*MYFLOAT_BIAS and want 1*MYFLOAT_BIAS
+
+  // Handle overflow/underflow
+  if (exponent_result >= MYFLOAT_EXPONENT_MASK) {
+    // Overflow: Set to max or min float value depending on sign
+    exponent_result = MYFLOAT_EXPONENT_MASK;
+    mantissa_product = MYFLOAT_IMPLICIT_ONE;
+  } else if (exponent_result <= 0) {
+    // Underflow: Return zero
+    exponent_result = 0;
+    mantissa_product = MYFLOAT_IMPLICIT_ONE;
+  }
+  result.exponent = exponent_result;
+  result.mantissa = mantissa_product;
+  return result;
+}
+
+//! \brief  negate an unpacked myfloat
+__static_inline myfloat_u myfloat_u_negate(myfloat_u a) {
+  a.sign ^= SIGN_MASK;
+  return a;
+}
+
+//! \brief  compare two unpacked myfloats
+//! \return 1 if a < b
+__static_inline uint32_t myfloat_u_less_than(myfloat_u a, myfloat_u b) {
+  // If the signs are different
+  if (a.sign != b.sign) {
+    return (a.sign > b.sign) ? 1 : 0;  // If a is negative and b is positive, return 1 (a < b)
+  }
+
+  // Same signs: compare based on exponent and mantissa
+  if (a.exponent != b.exponent) {
+    if (a.sign == 0) {  // Both are positive
+      return (a.exponent < b.exponent) ? 1 : 0;  
+    } else {  // Both are negative
+      return (a.exponent > b.exponent) ? 1 : 0; 
+    }
+  }
+
+  // Same exponents: compare mantissa
+  if (a.mantissa != b.mantissa) {
+    if (a.sign == 0) {  // Both are positive
+      return (a.mantissa < b.mantissa) ? 1 : 0;
+    } else {  // Both are negative
+      return (a.mantissa > b.mantissa) ? 1 : 0;
+    }
+  }
+  return 0;  // If all are equal so false 
+}
+
+//! \brief  test two unpacked myfloats for equal bits
+__static_inline uint32_t myfloat_u_equal(myfloat_u a, myfloat_u b) {
+  return (a.sign == b.sign) && (a.exponent == b.exponent) && (a.mantissa == b.mantissa);
+}
+
+
+// Compute a whole orbit step with myfloat_u_mandel_step instead of the separate operations. Off
+// by default: its wider intermediates round differently, so iteration counts change
+// (FUSED_STEP=1 in the makefile, host/build/myfloat_accuracy compares both).
+#ifndef MYFLOAT_FUSED_STEP
+#define MYFLOAT_FUSED_STEP 0
+#endif
+#define MYFLOAT_WIDE_GUARD_BITS  7                                              // extra mantissa bits inside the fused step
+#define MYFLOAT_WIDE_ONE         (MYFLOAT_IMPLICIT_ONE << MYFLOAT_WIDE_GUARD_BITS) // implicit one of a wide mantissa (bit 30)
+
+//! \brief Intermediate of the fused step: wider mantissa, unbounded exponent and a real zero
+typedef struct
+{
+  uint32_t sign;      // SIGN_MASK or 0
+  int32_t exponent;   // biased exponent, may leave 0 .. 255
+  uint32_t mantissa;  // normalized to bit 30, 0 for zero
+} myfloat_w;
+
+//! \brief  Widen an unpacked myfloat
+__static_inline myfloat_w myfloat_widen(myfloat_u a) {
+  myfloat_w w;
+  w.sign = a.sign;
+  w.exponent = a.exponent;
+  w.mantissa = a.mantissa << MYFLOAT_WIDE_GUARD_BITS;
+  return w;
+}
+
+//! \brief  Round a wide intermediate (by truncation) to an unpacked myfloat
+//! \note   Zero and underflow give the smallest magnitude, overflow saturates as myfloat_multiply
+__static_inline myfloat_u myfloat_narrow(myfloat_w w) {
+  myfloat_u u;
+  u.sign = w.sign;
+  u.mantissa = MYFLOAT_IMPLICIT_ONE;
+  if ((w.mantissa == 0) || (w.exponent <= 0)) {
+    u.exponent = 0;
+  } else if (w.exponent >= MYFLOAT_EXPONENT_MASK) {
+    u.exponent = MYFLOAT_EXPONENT_MASK;
+  } else {
+    u.exponent = w.exponent;
+    u.mantissa = w.mantissa >> MYFLOAT_WIDE_GUARD_BITS;
+  }
+  return u;
+}
+
+//! \brief  multiply two unpacked myfloats keeping the guard bits of the product
+__static_inline myfloat_w myfloat_w_product(myfloat_u a, myfloat_u b) {
+  myfloat_w w;
+  uint64_t mantissa_product = (uint64_t)a.mantissa * (uint64_t)b.mantissa;   // 1.0 <= product < 4.0 at bit 46
+  w.sign = a.sign ^ b.sign;
+  w.exponent = (int32_t)(a.exponent + b.exponent - MYFLOAT_BIAS);
+  if (mantissa_product >= (1ULL << (2*MYFLOAT_MANTISSA_NUM_BIT + 1))) {
+    w.mantissa = mantissa_product >> (MYFLOAT_MANTISSA_NUM_BIT - MYFLOAT_WIDE_GUARD_BITS + 1);
+    w.exponent++;
+  } else {
+    w.mantissa = mantissa_product >> (MYFLOAT_MANTISSA_NUM_BIT - MYFLOAT_WIDE_GUARD_BITS);
+  }
+  return w;
+}
+
+//! \brief  add two wide intermediates
+__static_inline myfloat_w myfloat_w_addition(myfloat_w a, myfloat_w b) {
+  if (b.mantissa == 0) return a;
+  if (a.mantissa == 0) return b;
+  if (a.exponent < b.exponent) {    // a has the larger exponent
+    myfloat_w t = a;
+    a = b;
+    b = t;
+  }
+  uint32_t shift = a.exponent - b.exponent;
+  uint32_t mantissa_b = (shift < 32) ? (b.mantissa >> shift) : 0;
+  myfloat_w result;
+  result.exponent = a.exponent;
+  if (a.sign == b.sign) {
+    result.sign = a.sign;
+    result.mantissa = a.mantissa + mantissa_b;   // below 2^32, both are below 2^31
+    if (result.mantissa & (MYFLOAT_WIDE_ONE << 1)) {
+      result.mantissa >>= 1;
+      result.exponent++;
+    }
+  } else {
+    if (a.mantissa >= mantissa_b) {
+      result.mantissa = a.mantissa - mantissa_b;
+      result.sign = a.sign;
+    } else {
+      result.mantissa = mantissa_b - a.mantissa;
+      result.sign = b.sign;
+    }
+    if (result.mantissa == 0) {
+      result.sign = 0;
+      return result;
+    }
+#if MYFLOAT_NORMALIZE_CLZ
+    uint32_t shift = myfloat_clz(result.mantissa) - 1;   // moves the leading one to bit 30
+    result.mantissa <<= shift;
+    result.exponent -= shift;
+#else
+    while ((result.mantissa & MYFLOAT_WIDE_ONE) == 0) {
+      result.mantissa <<= 1;
+      result.exponent--;
+    }
+#endif
+  }
+  return result;
+}
+
+//! \brief  One Mandelbrot step z = z^2 + c on unpacked values
+//! \param  x   real part of z, replaced by x^2 - y^2 + cx
+//! \param  y   imaginary part of z, replaced by 2xy + cy
+//! \param  cx  x-coordinate
+//! \param  cy  y-coordinate
+//! \return     |z|^2 of the z passed in
+//! \note   The three products and the additions keep MYFLOAT_WIDE_GUARD_BITS extra bits and
+//!         are rounded once at the end, 2xy is x*y with the exponent incremented.
+__static_inline myfloat_u myfloat_u_mandel_step(myfloat_u *x, myfloat_u *y, myfloat_u cx, myfloat_u cy) {
+  myfloat_w xx = myfloat_w_product(*x, *x);
+  myfloat_w yy = myfloat_w_product(*y, *y);
+  myfloat_w two_xy = myfloat_w_product(*x, *y);
+  two_xy.exponent++;
+  myfloat_w minus_yy = yy;
+  minus_yy.sign ^= SIGN_MASK;
+  *x = myfloat_narrow(myfloat_w_addition(myfloat_w_addition(xx, minus_yy), myfloat_widen(cx)));
+  *y = myfloat_narrow(myfloat_w_addition(two_xy, myfloat_widen(cy)));
+  return myfloat_narrow(myfloat_w_addition(xx, yy));
+}
+
+
+#if MANDELBROT_CARDIOID_CHECK
+//! \brief  Test whether c lies inside the main cardioid or the period-2 bulb
+//! \param  cx    x-coordinate
+//! \param  cy    y-coordinate
+//! \return       1 if (cx, cy) is known to be part of the Mandelbrot set
+static int in_cardioid_or_bulb(myfloat cx, myfloat cy) {
+  myfloat one = float_to_myfloat(1.0);
+  myfloat quarter = float_to_myfloat(0.25);
+  myfloat yy = myfloat_multiply(cy, cy);
+  // period-2 bulb: (x + 1)^2 + y^2 < 1/16
+  myfloat x_plus_one = myfloat_addition(cx, one);
+  if (myfloat_less_than(myfloat_addition(myfloat_multiply(x_plus_one, x_plus_one), yy), float_to_myfloat(0.0625))) {
+    return 1;
+  }
+  // main cardioid: q (q + x - 1/4) < y^2 / 4 with q = (x - 1/4)^2 + y^2
+  myfloat x_minus_quarter = myfloat_addition(cx, myfloat_negate(quarter));
+  myfloat q = myfloat_addition(myfloat_multiply(x_minus_quarter, x_minus_quarter), yy);
+  return myfloat_less_than(myfloat_multiply(q, myfloat_addition(q, x_minus_quarter)), myfloat_multiply(quarter, yy));
+}
+#endif
+
+
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
 //! \param  cy    y-coordinate
 //! \param  n_max maximum number of iterations
 //! \return       number of performed iterations at coordinate (cx, cy)
-uint16_t calc_mandelbrot_point_soft(myfloat cx, myfloat cy, uint16_t n_max) {
-  myfloat x = cx;
-  myfloat y = cy;
+__static_inline uint16_t calc_mandelbrot_point_soft_inline(myfloat cx, myfloat cy, uint16_t n_max) {
+#if MANDELBROT_CARDIOID_CHECK
+  if (in_cardioid_or_bulb(cx, cy)) {
+    return n_max;
+  }
+#endif
+  // The orbit is kept unpacked, only the arguments are unpacked once
+  myfloat_u ux = myfloat_unpack(cx);
+  myfloat_u uy = myfloat_unpack(cy);
+  myfloat_u x = ux;
+  myfloat_u y = uy;
   uint16_t n = 0;
-  myfloat xx, yy, two_xy, minus_yy;
-  myfloat two = float_to_myfloat(2.0);
-  myfloat four = float_to_myfloat(4.0);
+  myfloat_u r2;
+#if !MYFLOAT_FUSED_STEP
+  myfloat_u xx, yy, two_xy, minus_yy;
+  myfloat_u two = myfloat_unpack(float_to_myfloat(2.0));
+#endif
+  myfloat_u four = myfloat_unpack(float_to_myfloat(4.0));
+#if MANDELBROT_PERIODICITY_CHECK
+  myfloat_u x_old = x;
+  myfloat_u y_old = y;
+  uint16_t period_len = MANDELBROT_PERIOD_START;
+  uint16_t period_pos = 0;
+#endif
   do {
-    xx = myfloat_multiply(x, x);
-    yy = myfloat_multiply(y, y);
-    two_xy = myfloat_multiply(myfloat_multiply(two, x), y);
-    minus_yy = myfloat_negate(yy);
-
-    x = myfloat_addition(myfloat_addition(xx, minus_yy), cx);
-    y = myfloat_addition(two_xy, cy);
+#if MYFLOAT_FUSED_STEP
+    r2 = myfloat_u_mandel_step(&x, &y, ux, uy);
+#else
+    xx = myfloat_u_multiply(x, x);
+    yy = myfloat_u_multiply(y, y);
+    two_xy = myfloat_u_multiply(myfloat_u_multiply(two, x), y);
+    minus_yy = myfloat_u_negate(yy);
+
+    x = myfloat_u_addition(myfloat_u_addition(xx, minus_yy), ux);
+    y = myfloat_u_addition(two_xy, uy);
+    r2 = myfloat_u_addition(xx, yy);
+#endif
     ++n;
-  } while ((myfloat_less_than(myfloat_addition(xx, yy), four)) && (n < n_max));
+#if MANDELBROT_PERIODICITY_CHECK
+    // A repeated point (that did not escape) means the orbit is caught in a cycle
+    if (myfloat_u_equal(x, x_old) && myfloat_u_equal(y, y_old) && myfloat_u_positive_less_than(r2, four)) {
+      return n_max;
+    }
+    if (++period_pos == period_len) {
+      period_pos = 0;
+      period_len <<= 1;
+      x_old = x;
+      y_old = y;
+    }
+#endif
+  } while (myfloat_u_positive_less_than(r2, four) && (n < n_max));
   return n;
 }
 
+//! \brief  Function pointer form of calc_mandelbrot_point_soft_inline
+uint16_t calc_mandelbrot_point_soft(myfloat cx, myfloat cy, uint16_t n_max) {
+  return calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+}
+
 
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_bw_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
   return 0xffff;
 }
 
+//! \brief  Function pointer form of iter_to_bw_inline
+rgb565 iter_to_bw(uint16_t iter, uint16_t n_max) {
+  return iter_to_bw_inline(iter, n_max);
+}
+
 
 //! \brief  Map number of performed iterations to grayscale
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return       colour
-rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_grayscale_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -81,6 +493,11 @@ rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
   return swap_u16(((brightness << 12) | ((brightness << 7) | brightness<<1)));
 }
 
+//! \brief  Function pointer form of iter_to_grayscale_inline
+rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max) {
+  return iter_to_grayscale_inline(iter, n_max);
+}
+
 
 //! \brief Calculate binary logarithm for unsigned integer argument x
 //! \note  For x equal 0, the function returns -1.
@@ -100,7 +517,7 @@ int ilog2(unsigned x) {
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
 //! \return colour in rgb565 format little Endian (big Endian for openrisc)
-rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+__static_inline rgb565 iter_to_colour_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -111,7 +528,12 @@ rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0x1f) << 11) | ((g & 0x1f) << 6) | ((b & 0x1f)));
 }
 
-rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+//! \brief  Function pointer form of iter_to_colour_inline
+rgb565 iter_to_colour(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour_inline(iter, n_max);
+}
+
+__static_inline rgb565 iter_to_colour1_inline(uint16_t iter, uint16_t n_max) {
   if (iter == n_max) {
     return 0x0000;
   }
@@ -122,6 +544,69 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
   return swap_u16(((r & 0xf) << 12) | ((g & 0xf) << 7) | ((b & 0xf)<<1));
 }
 
+//! \brief  Function pointer form of iter_to_colour1_inline
+rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
+  return iter_to_colour1_inline(iter, n_max);
+}
+
+//! \brief  Compute the number of iterations of every pixel
+//! \param  ibuf   iteration buffer of width * height entries
+//! \param  width  width of frame buffer
+//! \param  height height of frame buffer
+//! \param  cfp_p  pointer to fractal function
+//! \param  cx_0   start x-coordinate
+//! \param  cy_0   start y-coordinate
+//! \param  delta  increment for x- and y-coordinate
+//! \param  n_max  maximum number of iterations
+void draw_fractal_iter(uint16_t *ibuf, int width, int height, calc_frac_point_p cfp_p,
+                       myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max) {
+  uint16_t *iter = ibuf;
+  myfloat cy = cy_0;
+  for (int k = 0; k < height; ++k) {
+    myfloat cx = cx_0;
+    for(int i = 0; i < width; ++i) {
+      *(iter++) = (*cfp_p)(cx, cy, n_max);
+      cx = myfloat_addition(cx, delta);
+    }
+    cy = myfloat_addition(cy, delta);
+  }
+}
+
+//! \brief  Tabulate a colour map for every possible number of iterations
+//! \param  lut    palette of n_max + 1 entries
+//! \param  i2c_p  pointer to function mapping number of iterations to colour
+//! \param  n_max  maximum number of iterations
+void build_palette(rgb565 *lut, iter_to_colour_p i2c_p, uint16_t n_max) {
+  for (uint32_t iter = 0; iter <= n_max; ++iter) {
+    lut[iter] = (*i2c_p)(iter, n_max);
+  }
+}
+
+//! \brief  Colour an iteration buffer through a palette
+//! \param  fbuf     frame buffer, may be the same memory as ibuf
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+//! \param  lut      palette built by build_palette
+void colour_fractal(rgb565 *fbuf, const uint16_t *ibuf, int n_pixels, const rgb565 *lut) {
+  for (int p = 0; p < n_pixels; ++p) {
+    fbuf[p] = lut[ibuf[p]];
+  }
+}
+
+//! \brief  Sum of the iteration counts of a frame, left out of the frame time
+//! \param  timer    running frame timer, paused while summing
+//! \param  ibuf     iteration buffer
+//! \param  n_pixels number of pixels
+static uint32_t frame_iterations(perf_timer_t *timer, const uint16_t *ibuf, int n_pixels) {
+  perf_timer_pause(timer);
+  uint32_t n_iterations = 0;
+  for (int p = 0; p < n_pixels; ++p) {
+    n_iterations += ibuf[p];
+  }
+  perf_timer_resume(timer);
+  return n_iterations;
+}
+
 //! \brief  Draw fractal into frame buffer
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
@@ -131,26 +616,160 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 //! \param  cy_0   start y-coordinate
 //! \param  delta  increment for x- and y-coordinate
 //! \param  n_max  maximum number of iterations
+//! \note   The iteration counts are computed into fbuf first and then coloured in place
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max) {
-  
-  Time start, end;
-  readTime(&start);
-  rgb565 *pixel = fbuf;
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  PROFILE_BEGIN("draw_fractal");
+  rgb565 lut[n_max + 1];
+  PROFILE_BEGIN("build_palette");
+  build_palette(lut, i2c_p, n_max);
+  PROFILE_END();
+  // Iterations and the stores of the counts into the frame buffer
+  PROFILE_BEGIN("draw_fractal_iter");
+  draw_fractal_iter((uint16_t *) fbuf, width, height, cfp_p, cx_0, cy_0, delta, n_max);
+  PROFILE_END();
+  uint32_t n_iterations = frame_iterations(&timer, (uint16_t *) fbuf, width * height);
+  // Loads of the counts and palette, stores of the colours
+  PROFILE_BEGIN("colour_fractal");
+  colour_fractal(fbuf, (uint16_t *) fbuf, width * height, lut);
+  PROFILE_END();
+  PROFILE_END();
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal", width * height, n_iterations);
+}
+
+//! \brief  Iteration counts of a row with the Mandelbrot kernel inlined
+__static_inline void calc_mandelbrot_row_inline(uint16_t *iter, int width, myfloat cx, myfloat cy,
+                                                myfloat delta, uint16_t n_max) {
+  for (int i = 0; i < width; ++i) {
+    iter[i] = calc_mandelbrot_point_soft_inline(cx, cy, n_max);
+    cx = myfloat_addition(cx, delta);
+  }
+}
+
+//! \brief  Define draw_fractal_<name>, draw_fractal with the kernel and the colour map inlined
+//! \param  calc_row  inline function computing the iteration counts of a row
+//! \param  i2c       inline function mapping number of iterations to colour
+//! \note   Every row is computed into the frame buffer and coloured in place while it is cached
+#define DEFINE_FRACTAL_RENDERER(name, calc_row, i2c)                                   \
+void draw_fractal_##name(rgb565 *fbuf, int width, int height,                          \
+                         myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max) {  \
+  myfloat cy = cy_0;                                                                   \
+  for (int k = 0; k < height; ++k) {                                                   \
+    rgb565 *pixel = fbuf + k * width;                                                  \
+    calc_row((uint16_t *) pixel, width, cx_0, cy, delta, n_max);                       \
+    for (int i = 0; i < width; ++i) {                                                  \
+      pixel[i] = i2c(pixel[i], n_max);                                                 \
+    }                                                                                  \
+    cy = myfloat_addition(cy, delta);                                                  \
+  }                                                                                    \
+}
+
+DEFINE_FRACTAL_RENDERER(mandelbrot_bw, calc_mandelbrot_row_inline, iter_to_bw_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_grayscale, calc_mandelbrot_row_inline, iter_to_grayscale_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour, calc_mandelbrot_row_inline, iter_to_colour_inline)
+DEFINE_FRACTAL_RENDERER(mandelbrot_colour1, calc_mandelbrot_row_inline, iter_to_colour1_inline)
+
+//! Rectangles with a side of at most MS_MIN_SIZE pixels are computed instead of subdivided
+#define MS_MIN_SIZE 4
+
+//! \brief State of a Mariani-Silver frame, fbuf holds iteration counts until the colour pass
+typedef struct
+{
+  uint16_t *iter;           // iteration count per pixel, 0 when not computed yet
+  int width;
+  const myfloat *cx;        // x-coordinate per column
+  const myfloat *cy;        // y-coordinate per row
+  calc_frac_point_p cfp_p;
+  uint16_t n_max;
+  int n_computed;           // number of pixels actually evaluated
+} ms_frame;
+
+//! \brief  Iteration count of pixel (i, k), evaluated on first use
+static uint16_t ms_point(ms_frame *frame, int i, int k) {
+  uint16_t *iter = &frame->iter[k * frame->width + i];
+  if (*iter == 0) {
+    *iter = (*frame->cfp_p)(frame->cx[i], frame->cy[k], frame->n_max);
+    ++frame->n_computed;
+  }
+  return *iter;
+}
+
+//! \brief  Fill the rectangle (x0, y0) - (x1, y1) (corners included)
+//! \note   If the whole border has the same iteration count the interior gets that count,
+//!         otherwise the rectangle is split along its longer side
+static void ms_rect(ms_frame *frame, int x0, int y0, int x1, int y1) {
+  uint16_t n_iter = ms_point(frame, x0, y0);
+  int uniform = 1;
+  for (int i = x0; i <= x1; ++i) {
+    uniform &= (ms_point(frame, i, y0) == n_iter);
+    uniform &= (ms_point(frame, i, y1) == n_iter);
+  }
+  for (int k = y0 + 1; k < y1; ++k) {
+    uniform &= (ms_point(frame, x0, k) == n_iter);
+    uniform &= (ms_point(frame, x1, k) == n_iter);
+  }
+  if (uniform) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      uint16_t *iter = &frame->iter[k * frame->width];
+      for (int i = x0 + 1; i < x1; ++i) {
+        iter[i] = n_iter;
+      }
+    }
+  } else if ((x1 - x0 <= MS_MIN_SIZE) || (y1 - y0 <= MS_MIN_SIZE)) {
+    for (int k = y0 + 1; k < y1; ++k) {
+      for (int i = x0 + 1; i < x1; ++i) {
+        ms_point(frame, i, k);
+      }
+    }
+  } else if (x1 - x0 >= y1 - y0) {
+    int xm = (x0 + x1) / 2;
+    ms_rect(frame, x0, y0, xm, y1);
+    ms_rect(frame, xm, y0, x1, y1);
+  } else {
+    int ym = (y0 + y1) / 2;
+    ms_rect(frame, x0, y0, x1, ym);
+    ms_rect(frame, x0, ym, x1, y1);
+  }
+}
+
+//! \brief  Draw fractal into frame buffer by Mariani-Silver rectangle subdivision
+//! \note   Same parameters as draw_fractal. Rectangles whose border has a single
+//!         iteration count are filled without evaluating their interior.
+//! \return        number of pixels whose iteration count was computed
+int draw_fractal_ms(rgb565 *fbuf, int width, int height,
+                     calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                     myfloat cx_0, myfloat cy_0, myfloat delta, uint16_t n_max) {
+  perf_timer_t timer;
+  perf_timer_start(&timer);
+  // Coordinates are accumulated exactly like draw_fractal does
+  myfloat cx_table[width];
+  myfloat cy_table[height];
+  myfloat cx = cx_0;
+  for (int i = 0; i < width; ++i) {
+    cx_table[i] = cx;
+    cx = myfloat_addition(cx, delta);
+  }
   myfloat cy = cy_0;
   for (int k = 0; k < height; ++k) {
-    myfloat cx = cx_0;
-    for(int i = 0; i < width; ++i) {
-      uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
-      rgb565 colour = (*i2c_p)(n_iter, n_max);
-      *(pixel++) = colour;
-      cx = myfloat_addition(cx, delta);
-    }
+    cy_table[k] = cy;
     cy = myfloat_addition(cy, delta);
   }
-  readTime(&end);
-  printf("run time : %02X:%02X:%02X\n", end.hours - start.hours, end.minutes - start.minutes, end.seconds - start.seconds);
+  ms_frame frame = { (uint16_t *) fbuf, width, cx_table, cy_table, cfp_p, n_max, 0 };
+  for (int p = 0; p < width * height; ++p) {
+    frame.iter[p] = 0;
+  }
+  ms_rect(&frame, 0, 0, width - 1, height - 1);
+  rgb565 lut[n_max + 1];
+  build_palette(lut, i2c_p, n_max);
+  uint32_t n_iterations = frame_iterations(&timer, frame.iter, width * height);
+  colour_fractal(fbuf, frame.iter, width * height, lut);
+  perf_timer_pause(&timer);
+  perf_timer_report(&timer, "draw_fractal_ms", width * height, n_iterations);
+  return frame.n_computed;
 }
 
 //! \brief  Convert a IEEE float value to myfloat custom represention 
@@ -173,112 +792,41 @@ myfloat float_to_myfloat(float float_value) {
 
   // Assemble the myfloat value
   myfloat_value |= sign;  // sign in bit 31
-  myfloat_value |= (mantissa << MYFLOAT_EXPONENT_NUM_BIT);  // Mantissa in bit 8 :: bit 30
-  myfloat_value |= (exponent & MYFLOAT_EXPONENT_MASK);  // Exponent in bit 0 :: bit 7
+  myfloat_value |= (mantissa << MYFLOAT_MANTISSA_SHIFT);
+  myfloat_value |= (exponent & MYFLOAT_EXPONENT_MASK) << MYFLOAT_EXPONENT_SHIFT;
 
   return myfloat_value;
 }
 
+//! \brief  Convert a myfloat to IEEE float
+//! \param  myfloat_value  to be converted to float
+//! \note   Magnitudes below the float range are flushed to 0, above it they become infinity
+float myfloat_to_float(myfloat myfloat_value) {
+  union {
+      float f;
+      uint32_t bits;
+  } float_union;
+
+  myfloat_u u = myfloat_unpack(myfloat_value);
+  int32_t IEEE_exponent = (int32_t) u.exponent - (int32_t) BIAS_DIFFERENCE;
+  float_union.bits = u.sign;
+  if (IEEE_exponent >= IEEE_EXPONENT_MASK) {
+    float_union.bits |= IEEE_EXPONENT_MASK << IEEE_MANTISSA_NUM_BIT;
+  } else if (IEEE_exponent > 0) {
+    float_union.bits |= (IEEE_exponent << IEEE_MANTISSA_NUM_BIT) | (u.mantissa & IEEE_MANTISSA_MASK);
+  }
+  return float_union.f;
+}
+
 //! \brief  add two fixed-point numbers
 //! \param  a myfloat operand of addition
 //! \param  b myfloat operand of addition
 myfloat myfloat_addition(myfloat a, myfloat b) {
-  uint8_t exponent_a = a & MYFLOAT_EXPONENT_MASK;
-  uint8_t exponent_b = b & MYFLOAT_EXPONENT_MASK;
-  uint32_t mantissa_a = (a & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_EXPONENT_NUM_BIT; // Handle them in 0 :: 22 form  instead of 8 :: 30
-  uint32_t mantissa_b = (b & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_EXPONENT_NUM_BIT; // Handle them in 0 :: 22 form  instead of 8 :: 30
-  uint32_t sign_a = a & SIGN_MASK;
-  uint32_t sign_b = b & SIGN_MASK;
-
-  // Add the implicit 1 to the mantissa for normalized numbers
-  mantissa_a |= (1 << MYFLOAT_MANTISSA_NUM_BIT);  // Adding implicit 1
-  mantissa_b |= (1 << MYFLOAT_MANTISSA_NUM_BIT);  // Adding implicit 1
-
-  // Alignement of the exponents and mantissas
-  if (exponent_a > exponent_b) {
-    mantissa_b >>= exponent_a - exponent_b;
-    exponent_b =  exponent_a;
-  } else {
-    mantissa_a >>= exponent_b - exponent_a;
-    exponent_a = exponent_b;
-  }
-
-  // Perform addition or substraction operation
-  int32_t result_mantissa;
-  int32_t result_sign;
-  if (sign_a == sign_b) { // Same signs 
-    result_mantissa = mantissa_a + mantissa_b;
-    result_sign = sign_a;
-  } else {                // Different signs
-    if (mantissa_a > mantissa_b) {  // a is bigger that b
-      result_mantissa = mantissa_a - mantissa_b;
-      result_sign = sign_a;   
-    } else {                        // b is bigger than a
-      result_mantissa = mantissa_b - mantissa_a;
-      result_sign = sign_b; 
-    }
-  }
-
-  // Normalize the result
-  uint8_t result_exponent = exponent_a > exponent_b ? exponent_a : exponent_b; // maximum exponent
-  if (result_mantissa & (1 << (MYFLOAT_MANTISSA_NUM_BIT + 1))) {// Check for mantissa overflow 
-    result_mantissa >>= 1;
-    result_exponent++;
-  }
-  while ((result_mantissa & (1 << MYFLOAT_MANTISSA_NUM_BIT)) == 0 && result_mantissa != 0) { // while implicit one of result (bit23) is 0 and stop if result = 0 (in case of equal substraction)
-    result_mantissa <<= 1;
-    result_exponent--;
-  }
-  // Remove implicit one 
-  result_mantissa &= IEEE_MANTISSA_MASK;
-
-  myfloat result = result_sign | (result_mantissa << MYFLOAT_EXPONENT_NUM_BIT)  | result_exponent;
-  return result;
+  return myfloat_pack(myfloat_u_addition(myfloat_unpack(a), myfloat_unpack(b)));
 }
 
 myfloat myfloat_multiply(myfloat a, myfloat b) {
-  // Extract the sign, exponent, and mantissa from a and b
-  uint32_t sign_a = a & SIGN_MASK;
-  uint32_t sign_b = b & SIGN_MASK;
-  uint32_t sign_result = (sign_a ^ sign_b);  // XOR the signs to get the result's sign
-  uint8_t exponent_a = a & MYFLOAT_EXPONENT_MASK;
-  uint8_t exponent_b = b & MYFLOAT_EXPONENT_MASK;
-  uint32_t mantissa_a = (a & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_EXPONENT_NUM_BIT; // Handle them in 0 :: 22 form  instead of 8 :: 30
-  uint32_t mantissa_b = (b & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_EXPONENT_NUM_BIT; // Handle them in 0 :: 22 form  instead of 8 :: 30
-
-  // Add the implicit 1 to the mantissa for normalized numbers
-  mantissa_a |= (1 << MYFLOAT_MANTISSA_NUM_BIT);  
-  mantissa_b |= (1 << MYFLOAT_MANTISSA_NUM_BIT); 
-
-  // Multiply the mantissas
-  uint64_t mantissa_product = (uint64_t)mantissa_a * (uint64_t)mantissa_b;
-
-  // Normalize the mantissa result if needed
-  if (mantissa_product  >= (1ULL << 2*MYFLOAT_MANTISSA_NUM_BIT + 1)) {  // The mantissa product is greater than 2.0 in 64 bit format (becaue 2*23 = 46 bits)
-    mantissa_product >>= (MYFLOAT_MANTISSA_NUM_BIT + 1);  
-    exponent_a += 1;  // Adjust exponent for normalization
-  } else {
-    mantissa_product >>= MYFLOAT_MANTISSA_NUM_BIT;  // Normalize the product
-  }
-   // restore mantissa in its place (bit8::bit30)
-  mantissa_product <<= MYFLOAT_EXPONENT_NUM_BIT;
-  mantissa_product &= MYFLOAT_MANTISSA_MASK;
-
-  // Add the exponents 
-  int32_t exponent_result = (int32_t)(exponent_a + exponent_b - MYFLOAT_BIAS); // because by simply adding we have 2*MYFLOAT_BIAS and want 1*MYFLOAT_BIAS
-
-  // Handle overflow/underflow
-  if (exponent_result >= MYFLOAT_EXPONENT_MASK) {
-    // Overflow: Set to max or min float value depending on sign
-    return sign_result | MYFLOAT_EXPONENT_MASK;
-  } else if (exponent_result <= 0) {
-    // Underflow: Return zero
-    return sign_result;
-  }
-
-  myfloat result = sign_result  | mantissa_product | exponent_result;
-
-  return result;
+  return myfloat_pack(myfloat_u_multiply(myfloat_unpack(a), myfloat_unpack(b)));
 }
 
 myfloat myfloat_negate(myfloat a) {
@@ -286,50 +834,25 @@ myfloat myfloat_negate(myfloat a) {
 }
 
 uint32_t myfloat_less_than(myfloat a, myfloat b) {
-  // Extract the sign, exponent, and mantissa
-  uint32_t sign_a = a & SIGN_MASK;
-  uint32_t sign_b = b & SIGN_MASK;
-  uint8_t exponent_a = a & MYFLOAT_EXPONENT_MASK;
-  uint8_t exponent_b = b & MYFLOAT_EXPONENT_MASK;
-  uint32_t mantissa_a = (a & MYFLOAT_MANTISSA_MASK);
-  uint32_t mantissa_b = (b & MYFLOAT_MANTISSA_MASK);
-
-  // If the signs are different
-  if (sign_a != sign_b) {
-    return (sign_a > sign_b) ? 1 : 0;  // If a is negative and b is positive, return 1 (a < b)
-  }
-
-  // Same signs: compare based on exponent and mantissa
-  if (exponent_a != exponent_b) {
-    if (sign_a == 0) {  // Both are positive
-      return (exponent_a < exponent_b) ? 1 : 0;  
-    } else {  // Both are negative
-      return (exponent_a > exponent_b) ? 1 : 0; 
-    }
-  }
-
-  // Same exponents: compare mantissa
-  if (mantissa_a != mantissa_b) {
-    if (sign_a == 0) {  // Both are positive
-      return (mantissa_a < mantissa_b) ? 1 : 0;
-    } else {  // Both are negative
-      return (mantissa_a > mantissa_b) ? 1 : 0;
-    }
-  }
-  return 0;  // If all are equal so false 
+#if MYFLOAT_ORDERED_LAYOUT
+  return myfloat_order_key(a) < myfloat_order_key(b);
+#else
+  return myfloat_u_less_than(myfloat_unpack(a), myfloat_unpack(b));
+#endif
 }
 
-//! \brief  Sets a Time struct with the time read from RTC
-//! \param  time Pointer to Time struct
-void readTime(Time* time) {
-  time->hours = readRtcRegister(2);   
-  time->minutes = readRtcRegister(1); 
-  time->seconds = readRtcRegister(0); 
+myfloat myfloat_mandel_step(myfloat *x, myfloat *y, myfloat cx, myfloat cy) {
+  myfloat_u ux = myfloat_unpack(*x);
+  myfloat_u uy = myfloat_unpack(*y);
+  myfloat_u r2 = myfloat_u_mandel_step(&ux, &uy, myfloat_unpack(cx), myfloat_unpack(cy));
+  *x = myfloat_pack(ux);
+  *y = myfloat_pack(uy);
+  return myfloat_pack(r2);
 }
 
 void print_myfloat_bits(myfloat myfloat_value) {
-  int32_t mantissa = (myfloat_value & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_EXPONENT_NUM_BIT;
-  int32_t exponent = myfloat_value & MYFLOAT_EXPONENT_MASK;
+  int32_t mantissa = (myfloat_value & MYFLOAT_MANTISSA_MASK) >> MYFLOAT_MANTISSA_SHIFT;
+  int32_t exponent = (myfloat_value >> MYFLOAT_EXPONENT_SHIFT) & MYFLOAT_EXPONENT_MASK;
 
   // print sign bit
   int sign_bit = (myfloat_value >> 31) & 1;
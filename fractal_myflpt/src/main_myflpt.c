@@ -2,8 +2,11 @@
 #include "swap.h"
 #include "vga.h"
 #include "cache.h"
+#include <cache_tune.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <perf.h>
+#include <profile.h>
 
 
 // Constants describing the output device
@@ -16,6 +19,25 @@ const float CX_0 = -2.0;      //!< default start x-coordinate (-2.0 in Q4.28)
 const float CY_0 = -1.5;      //!< default start y-coordinate (-1.5 in Q4.28)
 const uint16_t N_MAX = 64;    //!< maximum number of iterations
 
+// Cache configurations enabled at startup, e.g. the ones found with make CACHE_TUNE=1
+#ifndef ICACHE_CFG
+#define ICACHE_CFG (CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO)
+#endif
+#ifndef DCACHE_CFG
+#define DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK)
+#endif
+
+#ifdef CACHE_TUNE
+#define TUNE_SIZE 128   //!< width and height of the frame of the tuning workload
+
+//! \brief  Tuning workload: iteration counts of the default view in a TUNE_SIZE x TUNE_SIZE frame
+//! \param  arg frame buffer of at least TUNE_SIZE x TUNE_SIZE pixels
+static void tune_workload(void *arg) {
+   draw_fractal_iter((uint16_t *) arg, TUNE_SIZE, TUNE_SIZE, &calc_mandelbrot_point_soft,
+                     float_to_myfloat(CX_0), float_to_myfloat(CY_0), float_to_myfloat((FRAC_WIDTH / TUNE_SIZE)), N_MAX);
+}
+#endif
+
 int main() {
    myfloat CX_0_myfloat = float_to_myfloat(CX_0);
    myfloat CY_0_myfloat = float_to_myfloat(CY_0);
@@ -28,12 +50,20 @@ int main() {
    int i;
    vga_clear();
    printf("Starting drawing a fractal in myfloat representation\n");
-#ifdef OR1300   
+   /* start the performance counters once, the frame timers and the benches only read them */
+   perf_init();
+   perf_start();
+#ifdef __OR1300__
+#ifdef CACHE_TUNE
+   /* time the cache configurations and keep the fastest enabled */
+   cache_tune(&tune_workload, frameBuffer, ICACHE_CFG, DCACHE_CFG, 2);
+#else
    /* enable the caches */
-   icache_write_cfg( CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO );
-   dcache_write_cfg( CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK );
+   icache_write_cfg( ICACHE_CFG );
+   dcache_write_cfg( DCACHE_CFG );
    icache_enable(1);
    dcache_enable(1);
+#endif
 #endif
    /* Enable the vga-controller's graphic mode */
    vga[0] = swap_u32(SCREEN_WIDTH);
@@ -43,7 +73,12 @@ int main() {
    /* Clear screen */
    for (i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
 
+#ifdef FRACTAL_RENDERER
+   /* Specialized renderer selected in the makefile (RENDERER=...) */
+   FRACTAL_RENDERER(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+#else
    draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+#endif
 
 #ifdef TEST_MODE   
    // Testing Addition
@@ -107,9 +142,78 @@ int main() {
 
    printf("Case 4 : \n");
    printf(" 12.9 less than 12.88 = %d\n", myfloat_less_than(float_to_myfloat(12.9) ,float_to_myfloat(12.88)));
+
+   // Normalization cost: (1 + 2^-d) - 1 leaves the leading one d bits below the implicit one
+   // (rebuild with -DMYFLOAT_NORMALIZE_CLZ=0 for the bit-at-a-time loop)
+   printf("************* CANCELLATION DEPTH BENCH TEST *************\n");
+   const int n_add = 1000;
+   volatile myfloat sink;
+   myfloat minus_one = float_to_myfloat(-1.0);
+   for (int depth = 1; depth <= 23; depth++) {
+      myfloat a = float_to_myfloat(1.0f + 1.0f / (1 << depth));
+      perf_cycles_t start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+      for (int t = 0; t < n_add; t++) sink = myfloat_addition(a, minus_one);
+      perf_cycles_t cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+      printf("depth %2d : %lld cycles/addition\n", depth, cycles / n_add);
+   }
+
+   // Comparisons (rebuild with -DMYFLOAT_ORDERED_LAYOUT=1 for the order-preserving encoding)
+   printf("************* COMPARISON BENCH TEST *************\n");
+   const float compare_values[] = { -16.5, -15.85, -2.0, -0.375, 0.0625, 0.375, 2.0, 4.0, 12.88, 12.9 };
+   const int n_values = sizeof(compare_values) / sizeof(compare_values[0]);
+   myfloat compare_myfloats[n_values];
+   int wrong = 0;
+   for (int i = 0; i < n_values; i++) compare_myfloats[i] = float_to_myfloat(compare_values[i]);
+   perf_cycles_t start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+   for (int i = 0; i < n_values; i++) {
+      for (int j = 0; j < n_values; j++) {
+         wrong += myfloat_less_than(compare_myfloats[i], compare_myfloats[j]) != (compare_values[i] < compare_values[j]);
+      }
+   }
+   perf_cycles_t compare_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - start_cycles;
+   printf("%d comparisons, %d wrong, %lld cycles/comparison\n", n_values * n_values, wrong,
+          compare_cycles / (n_values * n_values));
+
+   // Specialized renderer: cycles per pixel of the function pointer API and of the inlined variant
+   printf("************* SPECIALIZED RENDERER BENCH TEST *************\n");
+   const int n_pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+   uint32_t checksum_generic = 0, checksum_inlined = 0;
+   perf_cycles_t generic_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+   perf_cycles_t generic_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - generic_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_generic += frameBuffer[i];
+   perf_cycles_t inlined_start = perf_read_counter(PERF_COUNTER_RUNTIME);
+   draw_fractal_mandelbrot_colour(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+   perf_cycles_t inlined_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - inlined_start;
+   for (i = 0 ; i < n_pixels ; i++) checksum_inlined += frameBuffer[i];
+   printf("function pointers : %lld cycles/pixel (checksum %08X)\n", generic_cycles / n_pixels, checksum_generic);
+   printf("inlined           : %lld cycles/pixel (checksum %08X)\n", inlined_cycles / n_pixels, checksum_inlined);
+
+   // Mariani-Silver subdivision: pixels evaluated out of the frame, the cycles are reported by
+   // draw_fractal_ms
+   printf("************* MARIANI-SILVER BENCH TEST *************\n");
+   int n_computed = draw_fractal_ms(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+   printf("computed %d of %d pixels\n", n_computed, n_pixels);
+#endif
+
+#ifdef PROFILE
+   // Where the cycles of draw_fractal go, CSV for host/profile_table.py; the ten events take
+   // two passes over the eight counters
+   printf("************* DRAW_FRACTAL PROFILE *************\n");
+   const uint32_t profile_events[] = {
+      PERF_EXECUTED_INSTRUCTIONS_MASK, PERF_STALL_CYCLES_MASK, PERF_BRANCH_PENALTY_MASK,
+      PERF_ICACHE_MISS_MASK, PERF_DCACHE_MISS_MASK, PERF_DCACHE_WRITE_BACK_MASK,
+      PERF_DCACHE_CACHE_READ_MASK, PERF_DCACHE_CACHE_WRITE_MASK,
+      PERF_DCACHE_UNCACHE_WRITE_MASK, PERF_BUS_IDLE_MASK
+   };
+   profile_init(profile_events, sizeof(profile_events) / sizeof(profile_events[0]));
+   do {
+      draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0_myfloat,CY_0_myfloat,delta_myfloat,N_MAX);
+   } while (profile_next_pass());
+   profile_report_csv();
 #endif
 
-#ifdef OR1300   
+#ifdef __OR1300__
    dcache_flush();
 #endif
    printf("Done\n");
@@ -7,6 +7,13 @@ extern "C" {
 
 #define UART_BASE 0x50000000
 
+// Memories, as seen by the CPU
+#define SDRAM_BASE 0x00000000   // program, data and the CPU1 stack (top at 0x007FFFFC)
+#define SDRAM_SIZE 0x00800000
+#define SPM_BASE 0xC0000000     // scratch-pad memory, the SPM side of the DMA
+#define SPM_SIZE 0x00002000
+#define SSRAM_BASE 0xE0000000   // internal SSRAM, starts with the lock and atomic words
+
 void platform_init();
 
 #ifdef __cplusplus
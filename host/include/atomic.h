@@ -0,0 +1,35 @@
+#ifndef ATOMIC_INCLUDE_H
+#define ATOMIC_INCLUDE_H
+
+#include <defs.h>
+#include <stdint.h>
+#include <locks.h>
+
+#define NR_OF_ATOMICS 64
+
+/**
+ * @brief The atomic words of the internal SSRAM become a host array
+ *
+ */
+static volatile uint32_t host_atomic_words[NR_OF_ATOMICS];
+
+#define ATOMIC_WORD(id) (host_atomic_words + (id))
+
+/**
+ * @brief Host replacements of the l.cas based operations
+ *
+ */
+__static_inline uint32_t atomic_compare_exchange(volatile uint32_t *ptr, uint32_t expected, uint32_t desired) {
+    __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+}
+
+__static_inline uint32_t atomic_exchange(volatile uint32_t *ptr, uint32_t value) {
+    return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+__static_inline uint32_t atomic_fetch_add(volatile uint32_t *ptr, uint32_t value) {
+    return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+#endif /* ATOMIC_INCLUDE_H */
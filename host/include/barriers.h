@@ -0,0 +1,13 @@
+#ifndef BARRIERS_INCLUDE_H
+#define BARRIERS_INCLUDE_H
+
+#include <defs.h>
+
+/**
+ * @brief The host tools render on a single thread, there is nobody to wait for
+ *
+ */
+__static_inline void wait_for_barrier() {
+}
+
+#endif /* BARRIERS_INCLUDE_H */
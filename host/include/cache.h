@@ -0,0 +1,15 @@
+#ifndef CACHE_H_INCLUDED
+#define CACHE_H_INCLUDED
+
+#include <defs.h>
+
+#define CACHE_LINE_ALIGN 64
+
+/**
+ * @brief The host caches are coherent, flushing is not needed
+ *
+ */
+__static_inline void dcache_flush() {
+}
+
+#endif /* CACHE_H_INCLUDED */
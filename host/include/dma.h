@@ -0,0 +1,30 @@
+#ifndef __DMA_H__
+#define __DMA_H__
+
+#include <defs.h>
+#include <stdint.h>
+
+#define DMA_FROM_SPM_TO_MEM (1 << 8)
+#define DMA_FROM_MEM_TO_SPM (1 << 9)
+
+/**
+ * @brief The host has no DMA or scratch-pad memory, the tools do not use the SPM renderers
+ *
+ */
+__static_inline void dma_start(void *mem, void *spm, uint32_t size, uint32_t direction) {
+    (void) mem;
+    (void) spm;
+    (void) size;
+    (void) direction;
+}
+
+__static_inline uint32_t dma_wait() {
+    return 0;
+}
+
+__static_inline const char *dma_error_string(uint32_t status) {
+    (void) status;
+    return "ok";
+}
+
+#endif
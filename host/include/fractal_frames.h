@@ -0,0 +1,19 @@
+#ifndef FRACTAL_FRAMES_H
+#define FRACTAL_FRAMES_H
+
+#include <stdint.h>
+
+/**
+ * @brief Iteration counts of a frame computed by draw_fractal_iter of one fractal project with
+ *        calc_mandelbrot_point_soft. The view is converted to the number format of the project
+ *        the way its main does (through float).
+ *
+ * Each project is linked into its own object of which only <format>_frame is global, the
+ * fractal sources of the three projects define the same names.
+ *
+ */
+void flpt_frame(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max);
+void fxpt_frame(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max);
+void myflpt_frame(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max);
+
+#endif /* FRACTAL_FRAMES_H */
@@ -0,0 +1,24 @@
+#ifndef LOCKS_INCLUDE_H
+#define LOCKS_INCLUDE_H
+
+#include <defs.h>
+#include <stdint.h>
+
+#define LOCKS_START_ADDRESS 0xE0000000
+#define NR_OF_LOCKS 256
+
+/**
+ * @brief The host tools render on a single thread, a lock is always free
+ *
+ */
+__static_inline int get_lock(uint32_t lockId) {
+    (void) lockId;
+    return 0;
+}
+
+__static_inline int release_lock(uint32_t lockId) {
+    (void) lockId;
+    return 0;
+}
+
+#endif /* LOCKS_INCLUDE_H */
@@ -0,0 +1,46 @@
+#ifndef PERF_H_INCLUDED
+#define PERF_H_INCLUDED
+
+#include <defs.h>
+#include <stdint.h>
+#include <time.h>
+
+#define PERF_COUNTER_RUNTIME 8
+
+typedef unsigned long long perf_cycles_t;   // uint64_t of the or1k, printed with %lld
+
+typedef struct {
+    unsigned h, m, s, ms;
+} perf_time_t;
+
+/**
+ * @brief The host has no performance counters, the runtime counter counts nanoseconds of the
+ * monotonic clock (a 1 GHz "cpu") and the event counters read 0
+ *
+ */
+__static_inline void perf_init() {
+}
+
+__static_inline void perf_start() {
+}
+
+__static_inline void perf_stop() {
+}
+
+__static_inline uint32_t perf_cpu_freq() {
+    return 1000000;   // kHz
+}
+
+__static_inline perf_cycles_t perf_read_counter(unsigned counter_id) {
+    if (counter_id != PERF_COUNTER_RUNTIME) return 0;
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (perf_cycles_t) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+__static_inline perf_time_t perf_cycles_to_time(perf_cycles_t cycles) {
+    uint64_t ms = cycles / perf_cpu_freq();
+    return (perf_time_t) { .h = ms / 3600000, .m = ms / 60000 % 60, .s = ms / 1000 % 60, .ms = ms % 1000 };
+}
+
+#endif /* PERF_H_INCLUDED */
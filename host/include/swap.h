@@ -0,0 +1,18 @@
+#ifndef SWAP_H_INCLUDED
+#define SWAP_H_INCLUDED
+
+#include <defs.h>
+
+/**
+ * @brief Host replacement of the byte swaps done by the l.nios_rrr custom instruction
+ *
+ */
+__static_inline uint32_t swap_u32(uint32_t s) {
+    return __builtin_bswap32(s);
+}
+
+__static_inline uint16_t swap_u16(uint16_t s) {
+    return __builtin_bswap16(s);
+}
+
+#endif /* SWAP_H_INCLUDED */
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""Per-region table of the CSV printed by profile_report_csv (support/src/profile.c).
+
+usage: profile_table.py [uart.log]    (default: stdin)
+
+The CSV is taken from between the "# profile begin" and "# profile end" lines, the rest of the
+log is skipped; a log with several profiles gives one table each. Counts are inclusive of the
+nested regions, "self" is the share of the total cycles not spent in a nested region. With
+executed_instructions in the profile, CPI and the events per 1000 instructions are added.
+"""
+
+import csv
+import sys
+
+FIXED = ["id", "parent", "depth", "region", "calls", "cycles"]
+
+
+def profiles(lines):
+    block = None
+    for line in lines:
+        line = line.strip()
+        if line == "# profile begin":
+            block = []
+        elif line == "# profile end":
+            if block:
+                yield block
+            block = None
+        elif block is not None and line:
+            block.append(line)
+
+
+def print_table(block):
+    reader = csv.DictReader(block)
+    events = reader.fieldnames[len(FIXED):]
+    rows = list(reader)
+    for row in rows:
+        for key in ["id", "parent", "depth", "calls", "cycles"] + events:
+            row[key] = int(row[key])
+    by_id = {row["id"]: row for row in rows}
+    children = {row["id"]: [] for row in rows}
+    roots = []
+    for row in rows:
+        (children[row["parent"]] if row["parent"] in by_id else roots).append(row)
+    total = sum(row["cycles"] for row in roots) or 1
+
+    # Depth-first, so that nested regions follow their enclosing region
+    ordered = []
+    stack = list(reversed(roots))
+    while stack:
+        row = stack.pop()
+        ordered.append(row)
+        stack.extend(reversed(children[row["id"]]))
+
+    instructions = "executed_instructions" in events
+    name_width = max(len("  " * row["depth"] + row["region"]) for row in rows)
+    name_width = max(name_width, len("region"))
+    header = ["%-*s" % (name_width, "region"), "%8s" % "calls", "%14s" % "cycles", "%7s" % "total",
+              "%7s" % "self"]
+    if instructions:
+        header.append("%6s" % "CPI")
+    header += ["%*s" % (max(len(e), 12), e) for e in events]
+    print("  ".join(header))
+    for row in ordered:
+        nested = sum(child["cycles"] for child in children[row["id"]])
+        line = ["%-*s" % (name_width, "  " * row["depth"] + row["region"]),
+                "%8d" % row["calls"], "%14d" % row["cycles"],
+                "%6.1f%%" % (100.0 * row["cycles"] / total),
+                "%6.1f%%" % (100.0 * (row["cycles"] - nested) / total)]
+        if instructions:
+            n = row["executed_instructions"]
+            line.append("%6.2f" % (row["cycles"] / n) if n else "%6s" % "-")
+        line += ["%*d" % (max(len(e), 12), row[e]) for e in events]
+        print("  ".join(line))
+
+    if instructions:
+        print("\nper 1000 instructions")
+        header = ["%-*s" % (name_width, "region")]
+        header += ["%*s" % (max(len(e), 10), e) for e in events if e != "executed_instructions"]
+        print("  ".join(header))
+        for row in ordered:
+            n = row["executed_instructions"]
+            line = ["%-*s" % (name_width, "  " * row["depth"] + row["region"])]
+            for e in events:
+                if e == "executed_instructions":
+                    continue
+                width = max(len(e), 10)
+                line.append("%*.2f" % (width, 1000.0 * row[e] / n) if n else "%*s" % (width, "-"))
+            print("  ".join(line))
+
+
+def main():
+    source = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+    found = False
+    for block in profiles(source):
+        if found:
+            print()
+        print_table(block)
+        found = True
+    if not found:
+        sys.exit("no profile found (no '# profile begin' line)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Range analysis of the fixed-point Mandelbrot kernel (calc_mandelbrot_point_soft of fractal_fxpt)
+// for a view and an escape radius R. An iteration starts from a z that passed the escape test
+// (|z - c| = |z_prev|^2 < R^2, or z = c) and forms
+//   x, y, x^2, y^2, 2x, 2x * y, x^2 + y^2, x' = x^2 - y^2 + cx, y' = 2xy + cy
+// all of which have to be representable. The bounds are taken over the disc |z - c| <= R^2 for
+// c on a grid covering the view (and its corners), the orbits of a frame give the values that
+// are actually reached. The smallest NUM_INT whose range holds every bound needs no saturation
+// check in the loop and leaves the most fractional bits.
+//
+// usage: fixed_range [cx_min cx_max cy_min cy_max [R [n_max [width]]]]
+//        defaults: the view of main_fxpt (-2.0 .. 1.0, -1.5 .. 1.5), R = 2, n_max = 64,
+//        width = 512 pixels
+
+#define C_GRID        32          // c grid of (C_GRID + 1)^2 points over the view
+#define N_ANGLES      720         // points on the border of the disc around each c
+#define FRAME_SIZE    256         // frame of FRAME_SIZE x FRAME_SIZE orbits
+
+enum { Q_X, Q_Y, Q_XX, Q_YY, Q_TWO_X, Q_TWO_XY, Q_R2, Q_X_NEXT, Q_Y_NEXT, N_QUANTITIES };
+
+static const char *quantity_names[N_QUANTITIES] = {
+  "|x|", "|y|", "x^2", "y^2", "|2x|", "|2xy|", "x^2 + y^2", "|x'|", "|y'|"
+};
+
+//! \brief  Record the magnitudes of one iteration from (x, y) with constant (cx, cy)
+static void track(double *max, double x, double y, double cx, double cy) {
+  double v[N_QUANTITIES];
+  v[Q_X] = fabs(x);
+  v[Q_Y] = fabs(y);
+  v[Q_XX] = x * x;
+  v[Q_YY] = y * y;
+  v[Q_TWO_X] = fabs(2.0 * x);
+  v[Q_TWO_XY] = fabs(2.0 * x * y);
+  v[Q_R2] = x * x + y * y;
+  v[Q_X_NEXT] = fabs(x * x - y * y + cx);
+  v[Q_Y_NEXT] = fabs(2.0 * x * y + cy);
+  for (int q = 0; q < N_QUANTITIES; q++) {
+    if (v[q] > max[q]) max[q] = v[q];
+  }
+}
+
+static double overall(const double *max) {
+  double m = 0.0;
+  for (int q = 0; q < N_QUANTITIES; q++) {
+    if (max[q] > m) m = max[q];
+  }
+  return m;
+}
+
+int main(int argc, char **argv) {
+  double cx_min = -2.0, cx_max = 1.0, cy_min = -1.5, cy_max = 1.5;
+  double radius = 2.0;
+  int n_max = 64, width = 512;
+  if (argc > 4) {
+    cx_min = atof(argv[1]);
+    cx_max = atof(argv[2]);
+    cy_min = atof(argv[3]);
+    cy_max = atof(argv[4]);
+  }
+  if (argc > 5) radius = atof(argv[5]);
+  if (argc > 6) n_max = atoi(argv[6]);
+  if (argc > 7) width = atoi(argv[7]);
+  const double r2 = radius * radius;
+
+  // Bound: every z within R^2 of every c of the view
+  double bound[N_QUANTITIES] = { 0 };
+  for (int a = 0; a <= C_GRID; a++) {
+    for (int b = 0; b <= C_GRID; b++) {
+      double cx = cx_min + (cx_max - cx_min) * a / C_GRID;
+      double cy = cy_min + (cy_max - cy_min) * b / C_GRID;
+      track(bound, cx, cy, cx, cy);
+      for (int t = 0; t < N_ANGLES; t++) {
+        double phi = 2.0 * M_PI * t / N_ANGLES;
+        track(bound, cx + r2 * cos(phi), cy + r2 * sin(phi), cx, cy);
+      }
+    }
+  }
+
+  // Reached: the iterations of the orbits of a frame, as the kernel performs them
+  double reached[N_QUANTITIES] = { 0 };
+  for (int k = 0; k < FRAME_SIZE; k++) {
+    for (int i = 0; i < FRAME_SIZE; i++) {
+      double cx = cx_min + (cx_max - cx_min) * i / (FRAME_SIZE - 1);
+      double cy = cy_min + (cy_max - cy_min) * k / (FRAME_SIZE - 1);
+      double x = cx, y = cy, xx, yy;
+      int n = 0;
+      do {
+        track(reached, x, y, cx, cy);
+        xx = x * x;
+        yy = y * y;
+        y = 2.0 * x * y + cy;
+        x = xx - yy + cx;
+        ++n;
+      } while ((xx + yy < r2) && (n < n_max));
+    }
+  }
+
+  printf("view %g .. %g x %g .. %g, escape radius %g, n_max %d (frame of %d x %d orbits)\n\n",
+         cx_min, cx_max, cy_min, cy_max, radius, n_max, FRAME_SIZE, FRAME_SIZE);
+  printf("%-12s %12s %12s\n", "quantity", "bound", "reached");
+  for (int q = 0; q < N_QUANTITIES; q++) {
+    printf("%-12s %12.4f %12.4f\n", quantity_names[q], bound[q], reached[q]);
+  }
+
+  // A split holds the bound if its largest value, 2^NUM_INT - 2^-NUM_FRAC, is not below it
+  const double delta = fmax(cx_max - cx_min, cy_max - cy_min) / width;
+  const double max_bound = overall(bound);
+  int best = -1;
+  printf("\n%-8s %-8s %14s %14s %8s\n", "NUM_INT", "format", "largest value", "delta in ulps", "safe");
+  for (int num_int = 3; num_int <= 8; num_int++) {
+    int num_frac = 31 - num_int;
+    double largest = ldexp(1.0, num_int) - ldexp(1.0, -num_frac);
+    int safe = max_bound <= largest;
+    if (safe && (best < 0)) best = num_int;
+    printf("%-8d Q%d.%-6d %14.4f %14.1f %8s\n", num_int, num_int, num_frac, largest,
+           ldexp(delta, num_frac), safe ? "yes" : "no");
+  }
+  if (best < 0) {
+    printf("\nno 32-bit split holds this view, the kernel needs a saturation check\n");
+    return 1;
+  }
+  printf("\nsmallest safe split: Q%d.%d, build with make NUM_INT=%d\n", best, 31 - best, best);
+  return 0;
+}
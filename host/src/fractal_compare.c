@@ -0,0 +1,128 @@
+#include "fractal_frames.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Comparison of the flpt, fxpt and myflpt Mandelbrot kernels on a set of views and n_max:
+//   1. iteration counts of every pixel against the orbit computed in double
+//   2. a difference map per format, view and n_max (binary PGM, mid-grey where the counts
+//      agree, brighter where the format iterated longer, darker where it stopped earlier),
+//      written to the directory given as argument, build/ by default
+//   3. host throughput; it ranks the formats, the cycle counts have to come from the board
+
+#define FRAME_SIZE    256         // frame of FRAME_SIZE x FRAME_SIZE pixels
+#define DIFF_GAIN     4           // grey levels per iteration of difference in the maps
+
+//! View given by its centre and width, as a user would zoom in on it
+typedef struct
+{
+  const char *name;
+  double cx, cy;
+  double width;
+} view;
+
+//! Frame function of one number format
+typedef struct
+{
+  const char *name;
+  void (*frame)(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max);
+} format;
+
+static const view views[] = {
+  { "full",     -0.5,               0.0,               3.0    },
+  { "seahorse", -0.745,             0.11,              0.02   },
+  { "elephant",  0.28,              0.008,             0.02   },
+  { "minibrot", -1.7687,            0.0017,            0.004  },
+  { "spiral",   -0.743643887037151, 0.131825904205330, 1.0e-5 },
+};
+static const uint16_t n_maxs[] = { 64, 256, 1024 };
+static const format formats[] = {
+  { "flpt",   &flpt_frame   },
+  { "fxpt",   &fxpt_frame   },
+  { "myflpt", &myflpt_frame },
+};
+
+static uint16_t orbit_count_double(double cx, double cy, uint16_t n_max) {
+  double x = cx, y = cy, xx, yy;
+  uint16_t n = 0;
+  do {
+    xx = x * x;
+    yy = y * y;
+    y = 2.0 * x * y + cy;
+    x = xx - yy + cx;
+    ++n;
+  } while ((xx + yy < 4.0) && (n < n_max));
+  return n;
+}
+
+static double seconds(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+//! \brief  Write the signed difference of two iteration buffers as a binary PGM
+static void write_diff_map(const char *path, const uint16_t *ibuf, const uint16_t *ref, int n_pixels) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    perror(path);
+    return;
+  }
+  fprintf(f, "P5\n%d %d\n255\n", FRAME_SIZE, FRAME_SIZE);
+  for (int p = 0; p < n_pixels; p++) {
+    int grey = 128 + DIFF_GAIN * ((int) ibuf[p] - ref[p]);
+    fputc(grey < 0 ? 0 : (grey > 255 ? 255 : grey), f);
+  }
+  fclose(f);
+}
+
+int main(int argc, char **argv) {
+  const char *map_dir = (argc > 1) ? argv[1] : "build";   // the maps stay out of the source tree
+  const int n_pixels = FRAME_SIZE * FRAME_SIZE;
+  const int n_views = sizeof(views) / sizeof(views[0]);
+  const int n_n_maxs = sizeof(n_maxs) / sizeof(n_maxs[0]);
+  const int n_formats = sizeof(formats) / sizeof(formats[0]);
+  static uint16_t ref[FRAME_SIZE * FRAME_SIZE];
+  static uint16_t ibuf[FRAME_SIZE * FRAME_SIZE];
+  char path[256];
+
+  printf("%d x %d frames, iteration counts against the double orbit, difference maps in %s/\n\n",
+         FRAME_SIZE, FRAME_SIZE, map_dir);
+  printf("%-9s %6s %-7s %10s %11s %11s %10s %8s %9s\n", "view", "n_max", "format", "ms/frame",
+         "Mpixel/s", "Miter/s", "same", "mean|dn|", "max|dn|");
+  for (int v = 0; v < n_views; v++) {
+    const double delta = views[v].width / FRAME_SIZE;
+    const double cx_0 = views[v].cx - delta * (FRAME_SIZE / 2);
+    const double cy_0 = views[v].cy - delta * (FRAME_SIZE / 2);
+    for (int m = 0; m < n_n_maxs; m++) {
+      const uint16_t n_max = n_maxs[m];
+      for (int k = 0; k < FRAME_SIZE; k++) {
+        for (int i = 0; i < FRAME_SIZE; i++) {
+          ref[k * FRAME_SIZE + i] = orbit_count_double(cx_0 + i * delta, cy_0 + k * delta, n_max);
+        }
+      }
+      for (int f = 0; f < n_formats; f++) {
+        double start = seconds();
+        formats[f].frame(ibuf, FRAME_SIZE, FRAME_SIZE, cx_0, cy_0, delta, n_max);
+        double elapsed = seconds() - start;
+
+        long same = 0, sum_diff = 0, iterations = 0;
+        int max_diff = 0;
+        for (int p = 0; p < n_pixels; p++) {
+          int diff = abs((int) ibuf[p] - ref[p]);
+          same += (diff == 0);
+          sum_diff += diff;
+          iterations += ibuf[p];
+          if (diff > max_diff) max_diff = diff;
+        }
+        snprintf(path, sizeof(path), "%s/diff_%s_%s_%d.pgm", map_dir, formats[f].name, views[v].name, n_max);
+        write_diff_map(path, ibuf, ref, n_pixels);
+
+        printf("%-9s %6d %-7s %10.2f %11.2f %11.2f %9.2f%% %8.3f %9d\n", views[v].name, n_max,
+               formats[f].name, 1e3 * elapsed, 1e-6 * n_pixels / elapsed, 1e-6 * iterations / elapsed,
+               100.0 * same / n_pixels, (double) sum_diff / n_pixels, max_diff);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,6 @@
+#include "fractal_flpt.h"
+#include "fractal_frames.h"
+
+void flpt_frame(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max) {
+  draw_fractal_iter(ibuf, width, height, &calc_mandelbrot_point_soft, cx_0, cy_0, delta, n_max);
+}
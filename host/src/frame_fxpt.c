@@ -0,0 +1,7 @@
+#include "fractal_fxpt.h"
+#include "fractal_frames.h"
+
+void fxpt_frame(uint16_t *ibuf, int width, int height, double cx_0, double cy_0, double delta, uint16_t n_max) {
+  draw_fractal_iter(ibuf, width, height, &calc_mandelbrot_point_soft,
+                    float_to_fixed(cx_0), float_to_fixed(cy_0), float_to_fixed(delta), n_max);
+}
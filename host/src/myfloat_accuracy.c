@@ -0,0 +1,151 @@
+#include "fractal_myflpt.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Accuracy of the fused myfloat Mandelbrot step against the separate myfloat operations and
+// IEEE float, both measured against double:
+//   1. error of a single step from the same random (z, c), in units of 2^-23 relative to |z'|
+//   2. iteration counts of a frame compared with the counts of the double orbit
+
+#define N_STEPS       1000000     // random single steps
+#define FRAME_SIZE    256         // frame of FRAME_SIZE x FRAME_SIZE pixels
+#define FRAME_N_MAX   256
+#define ULP           (1.0 / (1 << 23))
+
+//! Orbit step and escape test of one number format, |z|^2 of the z passed in is returned
+typedef double (*step_p)(void *x, void *y, const void *cx, const void *cy);
+
+typedef struct
+{
+  const char *name;
+  double sum_err;
+  double max_err;
+  long same_count;      // pixels with the iteration count of the double orbit
+  long sum_count_diff;  // sum of |n - n_double|
+} format_stats;
+
+static double step_separate(void *x, void *y, const void *cx, const void *cy) {
+  myfloat *mx = x, *my = y;
+  myfloat xx = myfloat_multiply(*mx, *mx);
+  myfloat yy = myfloat_multiply(*my, *my);
+  myfloat two_xy = myfloat_multiply(myfloat_multiply(float_to_myfloat(2.0), *mx), *my);
+  *mx = myfloat_addition(myfloat_addition(xx, myfloat_negate(yy)), *(const myfloat *) cx);
+  *my = myfloat_addition(two_xy, *(const myfloat *) cy);
+  return myfloat_to_float(myfloat_addition(xx, yy));
+}
+
+static double step_fused(void *x, void *y, const void *cx, const void *cy) {
+  return myfloat_to_float(myfloat_mandel_step(x, y, *(const myfloat *) cx, *(const myfloat *) cy));
+}
+
+static double step_float(void *x, void *y, const void *cx, const void *cy) {
+  float *fx = x, *fy = y;
+  float xx = *fx * *fx;
+  float yy = *fy * *fy;
+  *fy = 2.0f * *fx * *fy + *(const float *) cy;
+  *fx = xx - yy + *(const float *) cx;
+  return xx + yy;
+}
+
+static double random_coordinate(double range) {
+  return range * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+//! \brief  Error of one step of format f (myfloat when is_myfloat, else float)
+static double step_error(step_p f, int is_myfloat, double x, double y, double cx, double cy) {
+  double ref_x = x * x - y * y + cx;
+  double ref_y = 2.0 * x * y + cy;
+  double got_x, got_y;
+  if (is_myfloat) {
+    myfloat mx = float_to_myfloat(x), my = float_to_myfloat(y);
+    myfloat mcx = float_to_myfloat(cx), mcy = float_to_myfloat(cy);
+    f(&mx, &my, &mcx, &mcy);
+    got_x = myfloat_to_float(mx);
+    got_y = myfloat_to_float(my);
+  } else {
+    float fx = x, fy = y, fcx = cx, fcy = cy;
+    f(&fx, &fy, &fcx, &fcy);
+    got_x = fx;
+    got_y = fy;
+  }
+  double norm = hypot(ref_x, ref_y);
+  if (norm == 0.0) return 0.0;
+  return hypot(got_x - ref_x, got_y - ref_y) / norm / ULP;
+}
+
+static uint16_t orbit_count(step_p f, int is_myfloat, double cx, double cy, uint16_t n_max) {
+  uint16_t n = 0;
+  double r2;
+  if (is_myfloat) {
+    myfloat mcx = float_to_myfloat(cx), mcy = float_to_myfloat(cy);
+    myfloat x = mcx, y = mcy;
+    do {
+      r2 = f(&x, &y, &mcx, &mcy);
+      ++n;
+    } while ((r2 < 4.0) && (n < n_max));
+  } else {
+    float fcx = cx, fcy = cy;
+    float x = fcx, y = fcy;
+    do {
+      r2 = f(&x, &y, &fcx, &fcy);
+      ++n;
+    } while ((r2 < 4.0) && (n < n_max));
+  }
+  return n;
+}
+
+static uint16_t orbit_count_double(double cx, double cy, uint16_t n_max) {
+  double x = cx, y = cy, xx, yy;
+  uint16_t n = 0;
+  do {
+    xx = x * x;
+    yy = y * y;
+    y = 2.0 * x * y + cy;
+    x = xx - yy + cx;
+    ++n;
+  } while ((xx + yy < 4.0) && (n < n_max));
+  return n;
+}
+
+int main() {
+  format_stats stats[] = { { "myfloat, separate ops" }, { "myfloat, fused step" }, { "IEEE float" } };
+  step_p steps[] = { &step_separate, &step_fused, &step_float };
+  int is_myfloat[] = { 1, 1, 0 };
+  const int n_formats = sizeof(stats) / sizeof(stats[0]);
+
+  srand(473);
+  for (long t = 0; t < N_STEPS; t++) {
+    double x = random_coordinate(2.0), y = random_coordinate(2.0);
+    double cx = random_coordinate(2.0), cy = random_coordinate(2.0);
+    for (int f = 0; f < n_formats; f++) {
+      double err = step_error(steps[f], is_myfloat[f], x, y, cx, cy);
+      stats[f].sum_err += err;
+      if (err > stats[f].max_err) stats[f].max_err = err;
+    }
+  }
+
+  const double delta = 3.0 / FRAME_SIZE;
+  for (int k = 0; k < FRAME_SIZE; k++) {
+    for (int i = 0; i < FRAME_SIZE; i++) {
+      double cx = -2.0 + i * delta, cy = -1.5 + k * delta;
+      uint16_t ref = orbit_count_double(cx, cy, FRAME_N_MAX);
+      for (int f = 0; f < n_formats; f++) {
+        int diff = (int) orbit_count(steps[f], is_myfloat[f], cx, cy, FRAME_N_MAX) - ref;
+        stats[f].same_count += (diff == 0);
+        stats[f].sum_count_diff += abs(diff);
+      }
+    }
+  }
+
+  printf("%d random steps, error relative to |z'| in units of 2^-23\n", N_STEPS);
+  printf("%d x %d frame with n_max %d, iteration counts against the double orbit\n\n",
+         FRAME_SIZE, FRAME_SIZE, FRAME_N_MAX);
+  printf("%-24s %10s %10s %12s %12s\n", "format", "mean err", "max err", "same count", "mean |dn|");
+  for (int f = 0; f < n_formats; f++) {
+    printf("%-24s %10.3f %10.1f %11.2f%% %12.4f\n", stats[f].name, stats[f].sum_err / N_STEPS,
+           stats[f].max_err, 100.0 * stats[f].same_count / (FRAME_SIZE * FRAME_SIZE),
+           (double) stats[f].sum_count_diff / (FRAME_SIZE * FRAME_SIZE));
+  }
+  return 0;
+}
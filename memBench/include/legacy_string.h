@@ -0,0 +1,12 @@
+#ifndef LEGACY_STRING_H_INCLUDED
+#define LEGACY_STRING_H_INCLUDED
+
+#include <defs.h>
+
+//! memcpy of support/src/string.c before the word-wide version (also handles overlap)
+void* legacy_memcpy(void* dst0, const void* src0, size_t length);
+
+//! memset of support/src/string.c before the word-wide version
+void* legacy_memset(void* dest, register int val, register size_t len);
+
+#endif // LEGACY_STRING_H_INCLUDED
@@ -0,0 +1,67 @@
+#include "legacy_string.h"
+
+// The byte-wise memcpy/memset of support/src/string.c before the word-wide versions, kept as
+// the baseline of the string benchmark. The volatile pointers force every byte store.
+
+typedef int word;
+
+#define wsize sizeof(word)
+#define wmask (wsize - 1)
+
+void* legacy_memcpy(void* dst0, const void* src0, size_t length) {
+    volatile char* dst = dst0;
+    const char* src = src0;
+    size_t t;
+
+    if (length == 0 || dst == src) /* nothing to do */
+        goto done;
+
+#define TLOOP(s) \
+    if (t)       \
+    TLOOP1(s)
+#define TLOOP1(s) \
+    do {          \
+        s;        \
+    } while (--t)
+
+    if ((unsigned long)dst < (unsigned long)src) {
+        t = (uintptr_t)src; /* only need low bits */
+        if ((t | (uintptr_t)dst) & wmask) {
+            if ((t ^ (uintptr_t)dst) & wmask || length < wsize)
+                t = length;
+            else
+                t = wsize - (t & wmask);
+            length -= t;
+            TLOOP1(*dst++ = *src++);
+        }
+        t = length / wsize;
+        TLOOP(*(word*)dst = *(word*)src; src += wsize; dst += wsize);
+        t = length & wmask;
+        TLOOP(*dst++ = *src++);
+    } else {
+        src += length;
+        dst += length;
+        t = (uintptr_t)src;
+        if ((t | (uintptr_t)dst) & wmask) {
+            if ((t ^ (uintptr_t)dst) & wmask || length <= wsize)
+                t = length;
+            else
+                t &= wmask;
+            length -= t;
+            TLOOP1(*--dst = *--src);
+        }
+        t = length / wsize;
+        TLOOP(src -= wsize; dst -= wsize; *(word*)dst = *(word*)src);
+        t = length & wmask;
+        TLOOP(*--dst = *--src);
+    }
+done:
+    return (dst0);
+}
+
+void* legacy_memset(void* dest, register int val, register size_t len) {
+    volatile unsigned char* ptr = (unsigned char*)dest;
+    while (len-- > 0)
+        *ptr++ = val;
+    return dest;
+}
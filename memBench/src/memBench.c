@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <vga.h>
+#include <perf.h>
+#include <cache.h>
+#include <platform.h>
+#include <string.h>
+#include <dma.h>
+#include "legacy_string.h"
+
+// Memory hierarchy characterization of SDRAM, SPM and SSRAM. The results are CSV lines, one
+// section per measurement, for plotting:
+//   latency    dependent loads (pointer chase) per working-set size and stride, with the D-cache
+//              misses and stall cycles per load
+//   knee       size steps where the latency grows by KNEE_PERCENT or more (cache capacities)
+//   bandwidth  sequential word reads and writes per working-set size
+//   memdist    latency and bandwidth of the largest working set per memory distance
+//   string     support memcpy/memmove/memset against the byte-wise versions they replaced, on
+//              frame buffer sized (512 KB) blocks
+//   dma        DMA transfers between SDRAM and SPM against memcpy per transfer size, the cycles
+//              to start a transfer, and a chain of half-SPM transfers through the SDRAM set
+// Fractions are printed with two decimals, the runs include the (8x unrolled) loop overhead.
+
+#define WORD_BYTES          4
+#define MIN_SET             256           // smallest working set in bytes
+#define SDRAM_SET           (64 * 1024)   // largest SDRAM working set, 8 x the largest cache
+#define SSRAM_OFFSET        0x400         // past the lock and atomic words
+#ifndef SSRAM_SET
+#define SSRAM_SET           0x1000        // largest SSRAM working set
+#endif
+#define N_ACCESSES          16384         // timed loads or stores per measurement
+#define KNEE_PERCENT        150           // latency step reported as a knee
+#define MEMDIST_STRIDE      64            // stride of the memory distance sweep
+#define FRAME_BYTES         (512 * 512 * 2)   // rgb565 frame buffer of the fractal applications
+#define ROW_BYTES           (512 * 2)
+
+typedef struct
+{
+  const char *name;
+  uint32_t *base;
+  uint32_t size;                          // largest working set in bytes
+} region;
+
+typedef struct
+{
+  perf_cycles_t cycles;
+  perf_cycles_t misses;
+  perf_cycles_t stalls;
+} counts;
+
+static uint32_t sdram_buffer[SDRAM_SET / WORD_BYTES];
+static uint32_t frame_a[(FRAME_BYTES + ROW_BYTES) / WORD_BYTES];
+static uint32_t frame_b[(FRAME_BYTES + ROW_BYTES) / WORD_BYTES];
+
+//! String operation under test, the arguments are those of memcpy
+typedef enum { STRING_COPY, STRING_MOVE, STRING_SET } string_op;
+
+typedef struct
+{
+  const char *name;
+  string_op op;
+  char *dst;
+  const char *src;
+} string_case;
+
+static const region regions[] = {
+  { "sdram", sdram_buffer, SDRAM_SET },
+  { "spm", (uint32_t *) SPM_BASE, SPM_SIZE },
+  { "ssram", (uint32_t *) (SSRAM_BASE + SSRAM_OFFSET), SSRAM_SET },
+};
+static const uint32_t strides[] = { 4, 16, 32, 64, 256 };   // bytes
+static const uint32_t memdists[] = { 1, 2, 4, 8, 16, 32 };
+
+static void counts_start(counts *c) {
+  c->misses = perf_read_counter(PERF_COUNTER_0);
+  c->stalls = perf_read_counter(PERF_COUNTER_1);
+  c->cycles = perf_read_counter(PERF_COUNTER_RUNTIME);
+}
+
+static void counts_stop(counts *c) {
+  c->cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - c->cycles;
+  c->misses = perf_read_counter(PERF_COUNTER_0) - c->misses;
+  c->stalls = perf_read_counter(PERF_COUNTER_1) - c->stalls;
+}
+
+//! Prints ",num/den" with two decimals
+static void print_ratio(perf_cycles_t num, perf_cycles_t den) {
+  perf_cycles_t hundredths = (num * 100 + den / 2) / den;
+  printf(",%lld.%02lld", hundredths / 100, hundredths % 100);
+}
+
+//! \brief  Ring of pointers through a working set, stride bytes apart
+static void build_chain(uint32_t *base, uint32_t size, uint32_t stride) {
+  uint32_t n = size / stride;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t next = (i + 1 == n) ? 0 : i + 1;
+    base[i * stride / WORD_BYTES] = (uint32_t) &base[next * stride / WORD_BYTES];
+  }
+}
+
+//! \brief  Follows the chain for n_loads dependent loads (a multiple of 8)
+static uint32_t *chase(uint32_t *p, uint32_t n_loads) {
+  for (uint32_t k = 0; k < n_loads; k += 8) {
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+    p = (uint32_t *) *(volatile uint32_t *) p;
+  }
+  return p;
+}
+
+//! \brief  Sums the words of a working set, repeated for n_words loads (a multiple of 8)
+static uint32_t read_words(const uint32_t *base, uint32_t size, uint32_t n_words) {
+  const uint32_t n = size / WORD_BYTES;
+  uint32_t sum = 0;
+  for (uint32_t k = 0; k < n_words; k += n) {
+    const volatile uint32_t *p = base;
+    for (uint32_t i = 0; i < n; i += 8) {
+      sum += p[i] + p[i + 1] + p[i + 2] + p[i + 3] + p[i + 4] + p[i + 5] + p[i + 6] + p[i + 7];
+    }
+  }
+  return sum;
+}
+
+//! \brief  Writes the words of a working set, repeated for n_words stores (a multiple of 8)
+static void write_words(uint32_t *base, uint32_t size, uint32_t n_words) {
+  const uint32_t n = size / WORD_BYTES;
+  for (uint32_t k = 0; k < n_words; k += n) {
+    volatile uint32_t *p = base;
+    for (uint32_t i = 0; i < n; i += 8) {
+      p[i] = k; p[i + 1] = k; p[i + 2] = k; p[i + 3] = k;
+      p[i + 4] = k; p[i + 5] = k; p[i + 6] = k; p[i + 7] = k;
+    }
+  }
+}
+
+//! \brief  Dependent load latency of a working set, after one warm-up round through it
+static counts latency(const region *r, uint32_t size, uint32_t stride) {
+  counts c;
+  build_chain(r->base, size, stride);
+  uint32_t *p = chase(r->base, (size / stride + 7) & ~7);
+  counts_start(&c);
+  p = chase(p, N_ACCESSES);
+  counts_stop(&c);
+  if (p == NULL) printf("broken chain\n");   // keeps the chase
+  return c;
+}
+
+static void print_latency(const char *section, const region *r, uint32_t memdist, uint32_t stride,
+                          uint32_t size, const counts *c) {
+  printf("%s,%s,%u,%u,%u", section, r->name, memdist, stride, size);
+  print_ratio(c->cycles, N_ACCESSES);
+  print_ratio(c->misses, N_ACCESSES);
+  print_ratio(c->stalls, N_ACCESSES);
+  printf("\n");
+}
+
+//! \brief  Read and write bandwidth of a working set, in bytes per cycle and MB/s
+static void bandwidth(const char *section, const region *r, uint32_t memdist, uint32_t size) {
+  counts rd, wr;
+  uint32_t freq = perf_cpu_freq();   // kHz
+  write_words(r->base, size, size / WORD_BYTES);
+  counts_start(&rd);
+  uint32_t sum = read_words(r->base, size, N_ACCESSES);
+  counts_stop(&rd);
+  counts_start(&wr);
+  write_words(r->base, size, N_ACCESSES);
+  counts_stop(&wr);
+  const perf_cycles_t bytes = (perf_cycles_t) N_ACCESSES * WORD_BYTES;
+  printf("%s,%s,%u,%u", section, r->name, memdist, size);
+  print_ratio(bytes, rd.cycles);
+  printf(",%lld", bytes * freq / (rd.cycles * 1000));
+  print_ratio(bytes, wr.cycles);
+  printf(",%lld", bytes * freq / (wr.cycles * 1000));
+  printf("\n");
+  if (sum == 1) printf("\n");   // keeps the reads
+}
+
+static void fill_frames() {
+  for (uint32_t i = 0; i < sizeof(frame_a) / WORD_BYTES; i++) {
+    frame_a[i] = i * 0x9E3779B9;
+    frame_b[i] = ~i;
+  }
+}
+
+static uint32_t frames_checksum() {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < sizeof(frame_a) / WORD_BYTES; i++) {
+    sum = (sum << 1 | sum >> 31) ^ frame_a[i] ^ (frame_b[i] * 3);
+  }
+  return sum;
+}
+
+//! \brief  Cycles of one string operation on FRAME_BYTES bytes, and the checksum of the frames
+static perf_cycles_t string_run(const string_case *c, int legacy, uint32_t *checksum) {
+  counts t;
+  fill_frames();
+  counts_start(&t);
+  if (c->op == STRING_SET) {
+    if (legacy) legacy_memset(c->dst, 0x5A, FRAME_BYTES);
+    else memset(c->dst, 0x5A, FRAME_BYTES);
+  } else if (legacy) {
+    legacy_memcpy(c->dst, c->src, FRAME_BYTES);   // the old memcpy handled overlap as well
+  } else if (c->op == STRING_MOVE) {
+    memmove(c->dst, c->src, FRAME_BYTES);
+  } else {
+    memcpy(c->dst, c->src, FRAME_BYTES);
+  }
+  counts_stop(&t);
+  *checksum = frames_checksum();
+  return t.cycles;
+}
+
+static void string_bench() {
+  char *a = (char *) frame_a, *b = (char *) frame_b;
+  const string_case cases[] = {
+    { "memset", STRING_SET, a, NULL },
+    { "memset, dst + 1", STRING_SET, a + 1, NULL },
+    { "memcpy", STRING_COPY, b, a },
+    { "memcpy, src + 2", STRING_COPY, b, a + 2 },
+    { "memcpy, src + 1", STRING_COPY, b, a + 1 },
+    { "memmove, one row up", STRING_MOVE, a, a + ROW_BYTES },
+    { "memmove, one row down", STRING_MOVE, a + ROW_BYTES, a },
+    { "memmove, one pixel right", STRING_MOVE, a + 2, a },
+  };
+  printf("string,operation,bytes,legacy cycles,cycles,legacy bytes/cycle,bytes/cycle,speedup,result\n");
+  for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    uint32_t legacy_sum, sum;
+    perf_cycles_t legacy = string_run(&cases[i], 1, &legacy_sum);
+    perf_cycles_t cycles = string_run(&cases[i], 0, &sum);
+    printf("string,%s,%u,%lld,%lld", cases[i].name, FRAME_BYTES, legacy, cycles);
+    print_ratio(FRAME_BYTES, legacy);
+    print_ratio(FRAME_BYTES, cycles);
+    print_ratio(legacy, cycles);
+    printf(",%s\n", (sum == legacy_sum) ? "ok" : "WRONG");
+  }
+}
+
+//! \brief  Writes back and drops the D-cache lines, the DMA does not snoop the cache
+static void dma_cache_sync() {
+#ifdef __OR1300__
+  dcache_flush();
+#endif
+}
+
+//! \brief  Number of words that differ
+static uint32_t compare_words(const uint32_t *a, const uint32_t *b, uint32_t size) {
+  uint32_t n_diff = 0;
+  for (uint32_t i = 0; i < size / WORD_BYTES; i++) n_diff += (a[i] != b[i]);
+  return n_diff;
+}
+
+static void print_dma(const char *direction, uint32_t size, perf_cycles_t memcpy_cycles,
+                      perf_cycles_t start_cycles, perf_cycles_t dma_cycles, uint32_t status, uint32_t n_diff) {
+  printf("dma,%s,%u,%lld,%lld,%lld", direction, size, memcpy_cycles, start_cycles, dma_cycles);
+  print_ratio(size, memcpy_cycles);
+  print_ratio(size, dma_cycles);
+  printf(",%s\n", status ? dma_error_string(status) : (n_diff ? "WRONG" : "ok"));
+}
+
+static void dma_bench() {
+  uint32_t *spm = (uint32_t *) SPM_BASE;
+  uint32_t *dst = frame_b;
+  counts t;
+  for (uint32_t i = 0; i < SDRAM_SET / WORD_BYTES; i++) sdram_buffer[i] = i * 0x9E3779B9;
+  printf("dma,direction,bytes,memcpy cycles,start cycles,dma cycles,memcpy bytes/cycle,dma bytes/cycle,result\n");
+  for (uint32_t size = MIN_SET; size <= SPM_SIZE; size <<= 1) {
+    // SDRAM to SPM
+    dma_cache_sync();
+    counts_start(&t);
+    memcpy(spm, sdram_buffer, size);
+    counts_stop(&t);
+    perf_cycles_t memcpy_cycles = t.cycles;
+    memset(spm, 0, size);
+    dma_cache_sync();
+    counts_start(&t);
+    dma_start(sdram_buffer, spm, size, DMA_FROM_MEM_TO_SPM);
+    perf_cycles_t start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - t.cycles;
+    uint32_t status = dma_wait();
+    counts_stop(&t);
+    print_dma("to spm", size, memcpy_cycles, start_cycles, t.cycles, status, compare_words(spm, sdram_buffer, size));
+
+    // SPM to SDRAM, the SPM still holds the start of the SDRAM set
+    dma_cache_sync();
+    counts_start(&t);
+    memcpy(dst, spm, size);
+    counts_stop(&t);
+    memcpy_cycles = t.cycles;
+    memset(dst, 0, size);
+    dma_cache_sync();
+    counts_start(&t);
+    dma_start(dst, spm, size, DMA_FROM_SPM_TO_MEM);
+    start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - t.cycles;
+    status = dma_wait();
+    counts_stop(&t);
+    dma_cache_sync();
+    print_dma("from spm", size, memcpy_cycles, start_cycles, t.cycles, status, compare_words(dst, sdram_buffer, size));
+  }
+
+  // The SDRAM set through the two SPM halves, as double buffering would fetch it
+  const uint32_t half = SPM_SIZE / 2;
+  const uint32_t n_desc = SDRAM_SET / half;
+  dma_desc_t desc[SDRAM_SET / (SPM_SIZE / 2)];
+  for (uint32_t d = 0; d < n_desc; d++) {
+    desc[d] = (dma_desc_t) { (char *) sdram_buffer + d * half, (char *) spm + (d & 1) * half, half,
+                             DMA_FROM_MEM_TO_SPM, (d + 1 < n_desc) ? &desc[d + 1] : NULL };
+  }
+  dma_cache_sync();
+  counts_start(&t);
+  for (uint32_t d = 0; d < n_desc; d++) memcpy(desc[d].spm, desc[d].mem, half);
+  counts_stop(&t);
+  perf_cycles_t memcpy_cycles = t.cycles;
+  dma_cache_sync();
+  counts_start(&t);
+  dma_chain_start(&desc[0]);
+  perf_cycles_t start_cycles = perf_read_counter(PERF_COUNTER_RUNTIME) - t.cycles;
+  uint32_t status = dma_chain_wait();
+  counts_stop(&t);
+  // The last two descriptors are left in the SPM halves
+  uint32_t n_diff = compare_words(desc[n_desc - 2].spm, desc[n_desc - 2].mem, half)
+                  + compare_words(desc[n_desc - 1].spm, desc[n_desc - 1].mem, half);
+  print_dma("chain to spm", SDRAM_SET, memcpy_cycles, start_cycles, t.cycles, status, n_diff);
+}
+
+int main() {
+  const int n_regions = sizeof(regions) / sizeof(regions[0]);
+  const int n_strides = sizeof(strides) / sizeof(strides[0]);
+  const int n_memdists = sizeof(memdists) / sizeof(memdists[0]);
+
+  vga_clear();
+  printf("Memory hierarchy benchmark\n");
+#ifdef __OR1300__
+  /* the cache configuration of the fractal applications */
+  icache_write_cfg( CACHE_DIRECT_MAPPED | CACHE_SIZE_8K | CACHE_REPLACE_FIFO );
+  dcache_write_cfg( CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK );
+  icache_enable(1);
+  dcache_enable(1);
+#endif
+  perf_init();
+  perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
+  perf_set_mask(PERF_COUNTER_1, PERF_STALL_CYCLES_MASK);
+  perf_start();
+  const uint32_t memdist = perf_memdist_get();
+  printf("cpu %u kHz, memory distance %u\n", perf_cpu_freq(), memdist);
+
+  printf("latency,region,memdist,stride,size,cycles/load,misses/load,stalls/load\n");
+  printf("knee,region,memdist,stride,size below,size above,latency ratio\n");
+  for (int r = 0; r < n_regions; r++) {
+    for (int s = 0; s < n_strides; s++) {
+      perf_cycles_t previous = 0;
+      uint32_t previous_size = 0;
+      for (uint32_t size = MIN_SET; size <= regions[r].size; size <<= 1) {
+        if (size / strides[s] < 2) continue;
+        counts c = latency(&regions[r], size, strides[s]);
+        print_latency("latency", &regions[r], memdist, strides[s], size, &c);
+        if (previous && (c.cycles * 100 >= previous * KNEE_PERCENT)) {
+          printf("knee,%s,%u,%u,%u,%u", regions[r].name, memdist, strides[s], previous_size, size);
+          print_ratio(c.cycles, previous);
+          printf("\n");
+        }
+        previous = c.cycles;
+        previous_size = size;
+      }
+    }
+  }
+
+  printf("bandwidth,region,memdist,size,read bytes/cycle,read MB/s,write bytes/cycle,write MB/s\n");
+  for (int r = 0; r < n_regions; r++) {
+    for (uint32_t size = MIN_SET; size <= regions[r].size; size <<= 1) {
+      bandwidth("bandwidth", &regions[r], memdist, size);
+    }
+  }
+
+  printf("memdist,region,memdist,stride,size,cycles/load,misses/load,stalls/load\n");
+  printf("memdist bandwidth,region,memdist,size,read bytes/cycle,read MB/s,write bytes/cycle,write MB/s\n");
+  for (int d = 0; d < n_memdists; d++) {
+    perf_memdist_set(memdists[d]);
+    for (int r = 0; r < n_regions; r++) {
+      counts c = latency(&regions[r], regions[r].size, MEMDIST_STRIDE);
+      print_latency("memdist", &regions[r], memdists[d], MEMDIST_STRIDE, regions[r].size, &c);
+      bandwidth("memdist bandwidth", &regions[r], memdists[d], regions[r].size);
+    }
+  }
+  perf_memdist_set(memdist);
+
+  string_bench();
+  dma_bench();
+
+#ifdef __OR1300__
+  dcache_flush();
+#endif
+  perf_stop();
+  printf("Done\n");
+}
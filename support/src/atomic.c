@@ -0,0 +1,8 @@
+#include <atomic.h>
+#include <stdint.h>
+
+void init_atomics() {
+  volatile uint32_t *words = ATOMIC_WORD(0);
+
+  for (int i=0; i < NR_OF_ATOMICS; i++) words[i] = 0;
+}
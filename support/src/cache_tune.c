@@ -0,0 +1,108 @@
+#include <cache_tune.h>
+#include <perf_timer.h>
+#include <stdio.h>
+
+// Names of the fields of a configuration, in cache.c
+extern const char* cache_size[];
+extern const char* cache_assoc[];
+extern const char* cache_policy[];
+
+static const uint32_t sizes[] = {
+    CACHE_SIZE_1K, CACHE_SIZE_2K, CACHE_SIZE_4K, CACHE_SIZE_8K
+};
+
+static const uint32_t ways[] = {
+    CACHE_DIRECT_MAPPED, CACHE_TWO_WAY, CACHE_FOUR_WAY
+};
+
+static const uint32_t policies[] = {
+    CACHE_REPLACE_FIFO, CACHE_REPLACE_PLRU, CACHE_REPLACE_LRU
+};
+
+//! Fills cfgs with the configurations of a cache, the replacement policy only for the
+//! associative ones, and returns their number
+static unsigned cache_configs(uint32_t *cfgs, int dcache) {
+    unsigned n = 0;
+    for (unsigned w = 0; w <= (unsigned) (dcache != 0); w++) {
+        uint32_t write = w ? CACHE_WRITE_BACK : CACHE_WRITE_THROUGH;
+        for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (unsigned a = 0; a < sizeof(ways) / sizeof(ways[0]); a++) {
+                unsigned n_policies = (ways[a] == CACHE_DIRECT_MAPPED) ? 1 : sizeof(policies) / sizeof(policies[0]);
+                for (unsigned p = 0; p < n_policies; p++) {
+                    cfgs[n++] = sizes[s] | ways[a] | policies[p] | write;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+void cache_configure(uint32_t icache_cfg, uint32_t dcache_cfg) {
+    // Write back the dirty lines before the D-cache changes shape
+    dcache_flush();
+    icache_flush();
+    dcache_enable(0);
+    icache_enable(0);
+    icache_write_cfg(icache_cfg);
+    dcache_write_cfg(dcache_cfg);
+    icache_enable(1);
+    dcache_enable(1);
+}
+
+void cache_print_cfg(uint32_t cfg, int dcache) {
+    printf("%s %s %s", cache_size[(cfg >> 30) & 3], cache_assoc[cfg & 3],
+           (cfg & 3) == 0 ? "-" : cache_policy[(cfg >> 16) & 3]);
+    if (dcache) printf(" %s", (cfg & CACHE_WRITE_BACK) ? "wb" : "wt");
+}
+
+//! Fastest of runs runs of the workload with a configuration, printed with it
+static perf_cycles_t cache_time(cache_tune_workload_t workload, void *arg,
+                                uint32_t icache_cfg, uint32_t dcache_cfg, unsigned runs) {
+    cache_configure(icache_cfg, dcache_cfg);
+    perf_cycles_t best = 0;
+    for (unsigned r = 0; r < runs; r++) {
+        perf_timer_t timer;
+        perf_timer_start(&timer);
+        workload(arg);
+        perf_cycles_t cycles = perf_timer_pause(&timer);
+        if ((r == 0) || (cycles < best)) best = cycles;
+    }
+    printf("icache ");
+    cache_print_cfg(icache_cfg, 0);
+    printf(", dcache ");
+    cache_print_cfg(dcache_cfg, 1);
+    printf(" : %lld cycles\n", best);
+    return best;
+}
+
+cache_tune_result_t cache_tune(cache_tune_workload_t workload, void *arg,
+                               uint32_t icache_cfg, uint32_t dcache_cfg, unsigned runs) {
+    uint32_t cfgs[CACHE_TUNE_MAX_CONFIGS];
+    runs = runs ? runs : 1;
+    printf("cache tuning, start configuration:\n");
+    cache_tune_result_t best = { icache_cfg, dcache_cfg, 0 };
+    best.cycles = cache_time(workload, arg, icache_cfg, dcache_cfg, runs);
+
+    // Ties keep the earlier configuration: the start one, then the smaller and simpler ones
+    for (int dcache = 1; dcache >= 0; dcache--) {
+        printf("%s sweep:\n", dcache ? "dcache" : "icache");
+        unsigned n = cache_configs(cfgs, dcache);
+        cache_tune_result_t sweep = best;
+        for (unsigned c = 0; c < n; c++) {
+            uint32_t i_cfg = dcache ? best.icache_cfg : cfgs[c];
+            uint32_t d_cfg = dcache ? cfgs[c] : best.dcache_cfg;
+            perf_cycles_t cycles = cache_time(workload, arg, i_cfg, d_cfg, runs);
+            if (cycles < sweep.cycles) sweep = (cache_tune_result_t) { i_cfg, d_cfg, cycles };
+        }
+        best = sweep;
+    }
+
+    cache_configure(best.icache_cfg, best.dcache_cfg);
+    printf("best: icache ");
+    cache_print_cfg(best.icache_cfg, 0);
+    printf(", dcache ");
+    cache_print_cfg(best.dcache_cfg, 1);
+    printf(" : %lld cycles\n", best.cycles);
+    printf("apply at startup: make ICACHE_CFG=0x%08x DCACHE_CFG=0x%08x\n", best.icache_cfg, best.dcache_cfg);
+    return best;
+}